@@ -52,6 +52,61 @@
 // the Xrtti API
 using namespace Xrtti;
 
+// Print a single value of a fundamental type
+static void DumpValue(Type::BaseType baseType, void *pValue)
+{
+    // Print out the value's type
+    switch (baseType) {
+    case Type::BaseType_Bool:
+        printf("bool: %s\n", * (bool *) pValue);
+        break;
+    case Type::BaseType_Char:
+        printf("char: %c\n", * (char *) pValue);
+        break;
+    case Type::BaseType_Unsigned_Char:
+        printf("unsigned char: %uc\n", * (unsigned char *) pValue);
+        break;
+    case Type::BaseType_WChar:
+        printf("wchar_t: %lc\n", * (wchar_t *) pValue);
+        break;
+    case Type::BaseType_Short:
+        printf("short: %s\n", * (short *) pValue);
+        break;
+    case Type::BaseType_Unsigned_Short:
+        printf("unsigned short: %us\n", * (unsigned short *) pValue);
+        break;
+    case Type::BaseType_Int:
+        printf("int: %d\n", * (int *) pValue);
+        break;
+    case Type::BaseType_Unsigned_Int:
+        printf("unsigned int: %ud\n", * (unsigned int *) pValue);
+        break;
+    case Type::BaseType_Long:
+        printf("long: %ld\n", * (long *) pValue);
+        break;
+    case Type::BaseType_Unsigned_Long:
+        printf("unsigned long: %uld\n", * (unsigned long *) pValue);
+        break;
+    case Type::BaseType_Long_Long:
+        printf("long long: %ll\n", * (long long *) pValue);
+        break;
+    case Type::BaseType_Unsigned_Long_Long:
+        printf("unsignd long long: %ull\n", 
+               * (unsigned long long *) pValue);
+        break;
+    case Type::BaseType_Float:
+        printf("float: %f\n", * (float *) pValue);
+        break;
+    case Type::BaseType_Double:
+        printf("double: %g\n", * (double *) pValue);
+        break;
+    default: // Type::BaseType_Long_Double:
+        printf("long double: %lg\n", * (long double *) pValue);
+        break;
+    }
+}
+
+
 // Dump a single object - the object MUST have a vtable!  In C++, Only objects
 // with vtables can have their types dynamically detected at runtime.
 void DumpObject(void *pObject, const std::type_info &typeinfo)
@@ -93,23 +148,19 @@ void DumpObject(void *pObject, const std::type_info &typeinfo)
 
         printf("    %s: ", field.GetName());
 
-        // First off, skip pointer and array types, for the purposes of
-        // this simple example.
-        if (field.GetType().GetArrayOrPointerCount()) {
-            printf("array or pointer\n");
-            continue;
-        }
+        const Type &type = field.GetType();
 
-        // Also, skip void, function, and structure types
-        if (field.GetType().GetBaseType() == Type::BaseType_Void) {
+        // Skip void, function, and structure types, for the purposes of this
+        // simple example
+        if (type.GetBaseType() == Type::BaseType_Void) {
             printf("void\n");
             continue;
         }
-        if (field.GetType().GetBaseType() == Type::BaseType_Function) {
+        if (type.GetBaseType() == Type::BaseType_Function) {
             printf("function\n");
             continue;
         }
-        if (field.GetType().GetBaseType() == Type::BaseType_Structure) {
+        if (type.GetBaseType() == Type::BaseType_Structure) {
             printf("structure\n");
             continue;
         }
@@ -117,54 +168,30 @@ void DumpObject(void *pObject, const std::type_info &typeinfo)
         // Get the value of the field
         void *pValue = field.Get(pObject);
 
-        // Print out the field's type
-        switch (field.GetType().GetBaseType()) {
-        case Type::BaseType_Bool:
-            printf("bool: %s\n", * (bool *) pValue);
-            break;
-        case Type::BaseType_Char:
-            printf("char: %c\n", * (char *) pValue);
-            break;
-        case Type::BaseType_Unsigned_Char:
-            printf("unsigned char: %uc\n", * (unsigned char *) pValue);
-            break;
-        case Type::BaseType_WChar:
-            printf("wchar_t: %lc\n", * (wchar_t *) pValue);
-            break;
-        case Type::BaseType_Short:
-            printf("short: %s\n", * (short *) pValue);
-            break;
-        case Type::BaseType_Unsigned_Short:
-            printf("unsigned short: %us\n", * (unsigned short *) pValue);
-            break;
-        case Type::BaseType_Int:
-            printf("int: %d\n", * (int *) pValue);
-            break;
-        case Type::BaseType_Unsigned_Int:
-            printf("unsigned int: %ud\n", * (unsigned int *) pValue);
-            break;
-        case Type::BaseType_Long:
-            printf("long: %ld\n", * (long *) pValue);
-            break;
-        case Type::BaseType_Unsigned_Long:
-            printf("unsigned long: %uld\n", * (unsigned long *) pValue);
-            break;
-        case Type::BaseType_Long_Long:
-            printf("long long: %ll\n", * (long long *) pValue);
-            break;
-        case Type::BaseType_Unsigned_Long_Long:
-            printf("unsignd long long: %ull\n", 
-                   * (unsigned long long *) pValue);
-            break;
-        case Type::BaseType_Float:
-            printf("float: %f\n", * (float *) pValue);
-            break;
-        case Type::BaseType_Double:
-            printf("double: %g\n", * (double *) pValue);
-            break;
-        default: // Type::BaseType_Long_Double:
-            printf("long double: %lg\n", * (long double *) pValue);
-            break;
+        // Also skip pointers and arrays of arrays; but print every element
+        // of a simple array.  The element stride of the array is the
+        // distance between its elements, so there is no need to work out
+        // the size of each element from its type.
+        if (type.GetArrayOrPointerCount() == 0) {
+            DumpValue(type.GetBaseType(), pValue);
+            continue;
+        }
+        if ((type.GetArrayOrPointerCount() > 1) ||
+            (type.GetArrayOrPointer(0).GetType() != 
+             ArrayOrPointer::Type_Array) ||
+            !type.GetArrayOrPointer(0).GetElementStride()) {
+            printf("array or pointer\n");
+            continue;
+        }
+
+        const Array &array = (const Array &) type.GetArrayOrPointer(0);
+        U32 stride = array.GetElementStride();
+        printf("array of %lu (%lu bytes):\n", 
+               (unsigned long) array.GetElementCount(), 
+               (unsigned long) type.GetSizeof());
+        for (U32 j = 0; j < array.GetElementCount(); j++) {
+            printf("        [%lu] ", (unsigned long) j);
+            DumpValue(type.GetBaseType(), ((char *) pValue) + (j * stride));
         }
     }
 
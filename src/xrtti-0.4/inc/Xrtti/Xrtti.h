@@ -45,14 +45,17 @@ namespace Xrtti {
  * Short names for fixed-width integer types
  ************************************************************************** **/
 
+typedef uint8_t            u8;        /**< 8-bit unsigned integer */
 typedef uint32_t           u32;       /**< 32-bit unsigned integer */
 typedef int32_t            s32;       /**< 32-bit signed integer */
+typedef uint64_t           u64;       /**< 64-bit unsigned integer */
 
 
 /** **************************************************************************
  * Forward declaration of classes and structures
  ************************************************************************** **/
 
+class Allocator;
 class Argument;
 class Array;
 class ArrayOrPointer;
@@ -66,7 +69,13 @@ class DestructorSignature;
 class Enumeration;
 class EnumerationValue;
 class Field;
+struct FieldLayout;
+class FieldPath;
 class Method;
+class MethodOverloads;
+#if __cplusplus >= 201103L
+template <typename Signature> class BoundMethod;
+#endif
 class MethodSignature;
 class Namespace;
 class Pointer;
@@ -276,6 +285,16 @@ public:
      **/
     virtual u32 GetSizeof() const = 0;
 
+    /**
+     * Returns the alignment of an instance of this Structure in memory, that
+     * is, the boundary which the address of each instance must be a multiple
+     * of.  Memory passed to ConstructAt() must be aligned to it.  This is
+     * only valid if HasSizeof() returns true.
+     *
+     * @return the alignment of an instance of this Structure in memory
+     **/
+    virtual u32 GetAlignof() const = 0;
+
     /**
      * Each Structure type (class, struct, union) can be defined in three
      * possible ways in C++, as illustrated by this example:
@@ -392,6 +411,52 @@ public:
      **/
     virtual const Field &GetField(u32 index) const = 0;
 
+    /**
+     * Returns the FieldLayout of each Field of this Structure, in the same
+     * order as GetField(), so that code which walks the Fields of many
+     * objects can do so without calling any virtual methods of the Fields.
+     *
+     * @return an array of GetFieldCount() FieldLayouts, or NULL if this
+     *         Structure has no Fields or their layout is not available
+     **/
+    virtual const FieldLayout *GetFieldLayout() const = 0;
+
+    /**
+     * Looks up a Field declared by this Structure by name.  The Fields of
+     * base Structures are not searched; LookupField() does that.
+     *
+     * @param pName is the name of the Field to look up
+     * @return the Field of this Structure with the given name, or NULL if
+     *         this Structure declares no such Field
+     **/
+    virtual const Field *LookupDeclaredField(const char *pName) const = 0;
+
+    /**
+     * Looks up a Field of this Structure or of any of its base Structures
+     * by name.  As in C++, a Field of this Structure hides any Field of the
+     * same name in its base Structures.  Base Structures are searched
+     * depth-first, and if different Fields of that name are found in more
+     * than one of them, the lookup is ambiguous and NULL is returned.  The
+     * same Field found through more than one Base, as from a shared virtual
+     * base, is not ambiguous; *ppInstance is then cast along the first Base
+     * declared.
+     *
+     * The returned Field may belong to a base Structure, in which case its
+     * Get() method must be given an instance of that base Structure.  If
+     * ppInstance is not NULL, then *ppInstance must be an instance of this
+     * Structure, and is cast to an instance of the Structure which declares
+     * the returned Field, or set to NULL if some Base along the way is not
+     * castable.
+     *
+     * @param pName is the name of the Field to look up
+     * @param ppInstance if not NULL, gives an instance of this Structure to
+     *        be cast to an instance of the Structure which declares the
+     *        returned Field
+     * @return the Field with the given name, or NULL if there is no such
+     *         Field, in which case *ppInstance is left unchanged
+     **/
+    const Field *LookupField(const char *pName, void **ppInstance = 0) const;
+
     /**
      * Returns true if the Structure is anonymous.  Anonymous structures have
      * no type name and thus cannot be instantiated.  Therefore, the
@@ -491,6 +556,191 @@ public:
      * @param pInstanceArray is the array of objects to be deleted.
      **/
     virtual void DeleteArray(void *pInstanceArray) const = 0;
+
+    /**
+     * Constructs an object of this Structure type in the given memory, with
+     * the default constructor, and without allocating anything.  The memory
+     * must be at least GetSizeof() bytes long and aligned to GetAlignof().
+     * The object must be destroyed using the DestroyAt() method, after which
+     * the memory belongs to the caller again.  If the Structure is not
+     * creatable, this method must not be called.
+     *
+     * @param pMemory is the memory to construct the object in
+     * @return the constructed object, which is at pMemory
+     **/
+    virtual void *ConstructAt(void *pMemory) const = 0;
+
+    /**
+     * Destroys an object constructed by the ConstructAt() method, or by
+     * Constructor::ConstructAt(), by calling its destructor without freeing
+     * its memory.  If the Structure is not deletable, this method must not
+     * be called.
+     *
+     * @param pInstance is the object to be destroyed.
+     **/
+    virtual void DestroyAt(void *pInstance) const = 0;
+
+    /**
+     * Returns true if instances of this Structure can be copy constructed,
+     * from a const instance, by its declared or implicit copy constructor.
+     * Only if this method returns true may the CopyConstruct() or
+     * MoveConstruct() methods be called.
+     *
+     * @return true if instances of this Structure can be copy constructed
+     **/
+    virtual bool IsCopyConstructible() const = 0;
+
+    /**
+     * Returns true if instances of this Structure can be copy assigned,
+     * from a const instance, by its declared or implicit assignment
+     * operator.  Only if this method returns true may the CopyAssign() or
+     * MoveAssign() methods be called.
+     *
+     * @return true if instances of this Structure can be copy assigned
+     **/
+    virtual bool IsCopyAssignable() const = 0;
+
+    /**
+     * Returns true if instances of this Structure can be copied by copying
+     * their bytes, in which case CopyConstruct() and CopyAssign() simply
+     * do that, and a caller may do so itself, for example for a whole array
+     * at once.  When the generated code was compiled as C++11 or later this
+     * is std::is_trivially_copyable; otherwise it is only true for plain
+     * old data Structures.
+     *
+     * @return true if instances of this Structure can be copied by copying
+     *         their bytes
+     **/
+    virtual bool IsTriviallyCopyable() const = 0;
+
+    /**
+     * Returns true if destroying instances of this Structure does nothing,
+     * so that their memory may simply be freed or reused without calling
+     * DestroyAt().  When the generated code was compiled as C++11 or later
+     * this is std::is_trivially_destructible; otherwise it is only true for
+     * plain old data Structures.
+     *
+     * @return true if destroying instances of this Structure does nothing
+     **/
+    virtual bool IsTriviallyDestructible() const = 0;
+
+    /**
+     * Returns true if default constructing instances of this Structure does
+     * nothing, so that, for example, zeroed memory may be used as an
+     * instance without calling ConstructAt().  When the generated code was
+     * compiled as C++11 or later this is
+     * std::is_trivially_default_constructible; otherwise it is only true for
+     * plain old data Structures.
+     *
+     * @return true if default constructing instances of this Structure does
+     *         nothing
+     **/
+    virtual bool IsTriviallyDefaultConstructible() const = 0;
+
+    /**
+     * Returns true if instances of this Structure have the same layout as
+     * the equivalent C struct would have.  When the generated code was
+     * compiled as C++11 or later this is std::is_standard_layout; otherwise
+     * it is only true for plain old data Structures.
+     *
+     * @return true if instances of this Structure have standard layout
+     **/
+    virtual bool IsStandardLayout() const = 0;
+
+    /**
+     * Constructs a copy of an instance of this Structure in the given
+     * memory, which must be as large and as aligned as for ConstructAt().
+     * The copy must be destroyed using the DestroyAt() method.  If the
+     * Structure is not copy constructible, this method must not be called.
+     *
+     * @param pMemory is the memory to construct the copy in
+     * @param pOther is the instance to copy
+     * @return the constructed copy, which is at pMemory
+     **/
+    virtual void *CopyConstruct(void *pMemory, const void *pOther) const = 0;
+
+    /**
+     * Constructs an instance of this Structure in the given memory, just as
+     * CopyConstruct() does, but moving from [pOther], which is left in a
+     * valid but unspecified state.  This uses the move constructor if the
+     * generated code was compiled as C++11 or later and the Structure has
+     * one, and otherwise the copy constructor.
+     *
+     * @param pMemory is the memory to construct the instance in
+     * @param pOther is the instance to move from
+     * @return the constructed instance, which is at pMemory
+     **/
+    virtual void *MoveConstruct(void *pMemory, void *pOther) const = 0;
+
+    /**
+     * Assigns a copy of an instance of this Structure to another instance.
+     * If the Structure is not copy assignable, this method must not be
+     * called.
+     *
+     * @param pInstance is the instance to assign to
+     * @param pOther is the instance to copy
+     **/
+    virtual void CopyAssign(void *pInstance, const void *pOther) const = 0;
+
+    /**
+     * Assigns to an instance of this Structure just as CopyAssign() does,
+     * but moving from [pOther], which is left in a valid but unspecified
+     * state.  This uses the move assignment operator if the generated code
+     * was compiled as C++11 or later and the Structure has one, and
+     * otherwise the copy assignment operator.
+     *
+     * @param pInstance is the instance to assign to
+     * @param pOther is the instance to move from
+     **/
+    virtual void MoveAssign(void *pInstance, void *pOther) const = 0;
+
+    /**
+     * Returns a newly-constructed object of this Structure type, in memory
+     * from [allocator] rather than from global new; the default constructor
+     * is used.  The returned object must be deleted using the Delete()
+     * method which takes the same Allocator.  If the Structure is not
+     * creatable, this method must not be called.
+     *
+     * @param allocator is the Allocator to allocate the object from
+     * @return a newly-constructed object of this Structure type, or NULL if
+     *         [allocator] could not allocate it
+     **/
+    void *Create(Allocator &allocator) const;
+
+    /**
+     * Returns a newly-constructed array of objects of this Structure type,
+     * in memory from [allocator] rather than from global new; the default
+     * constructor is used.  The returned array must be deleted using the
+     * DeleteArray() method which takes the same Allocator.  If the
+     * Structure is not creatable, this method must not be called.
+     *
+     * @param count is the number of elements in the array to be created
+     * @param allocator is the Allocator to allocate the array from
+     * @return a newly-constructed array of objects of this Structure type,
+     *         or NULL if [allocator] could not allocate it
+     **/
+    void *CreateArray(u32 count, Allocator &allocator) const;
+
+    /**
+     * Deletes an object created by the Create() method which takes an
+     * Allocator, returning its memory to that Allocator.
+     *
+     * @param pInstance is the object to be deleted.
+     * @param allocator is the Allocator which the object was created from
+     **/
+    void Delete(void *pInstance, Allocator &allocator) const;
+
+    /**
+     * Deletes an array of objects created by the CreateArray() method which
+     * takes an Allocator, returning its memory to that Allocator.
+     *
+     * @param pInstanceArray is the array of objects to be deleted.
+     * @param count is the number of elements in the array, as passed to
+     *        CreateArray()
+     * @param allocator is the Allocator which the array was created from
+     **/
+    void DeleteArray(void *pInstanceArray, u32 count, 
+                     Allocator &allocator) const;
 };
 
 
@@ -592,6 +842,30 @@ public:
      *         Base object
      **/
     virtual void *CastSubclass(void *pObject) const = 0;
+
+    /**
+     * Returns true if the offset of this base within its subclass is
+     * available, and can be obtained by calling GetOffset().  This is only
+     * ever the case for castable, non-virtual bases, whose offset is the
+     * same for every instance of the subclass.  The offset is not compared
+     * by the == operator.
+     *
+     * @return true if the offset of this base within its subclass is
+     *         available, and can be obtained by calling GetOffset().
+     **/
+    virtual bool HasOffset() const = 0;
+
+    /**
+     * Returns the offset in bytes from the beginning of an instance of the
+     * subclass to its base class subobject described by this Base.  When
+     * HasOffset() returns true, adding this to a pointer to an instance of
+     * the subclass gives the same result as CastSubclass().  This value is
+     * undefined if HasOffset() returns false.
+     *
+     * @return the offset in bytes from the beginning of an instance of the
+     *         subclass to its base class subobject described by this Base
+     **/
+    virtual u32 GetOffset() const = 0;
 };
 
 
@@ -787,6 +1061,144 @@ public:
      * @return a Method of this Struct.
      **/
     virtual const Method &GetMethod(u32 index) const = 0;
+
+    /**
+     * Looks up the Methods declared by this Struct with the given name.
+     * The Methods of base Structs are not searched; LookupMethods() does
+     * that.
+     *
+     * @param pName is the name of the Methods to look up
+     * @return the Methods of this Struct with the given name, in the order
+     *         in which they were declared; this is empty if this Struct
+     *         declares no such Method
+     **/
+    virtual MethodOverloads LookupDeclaredMethods(const char *pName) const
+        = 0;
+
+    /**
+     * Looks up the overloaded Methods of this Struct or of any of its base
+     * Structs by name.  As in C++, the Methods of this Struct hide all
+     * Methods of the same name in its base Structs, so the returned Methods
+     * are always declared by a single Struct.  Base Structs are searched
+     * depth-first, and if Methods of that name are declared by more than
+     * one of them, the lookup is ambiguous and no Methods are returned.
+     * The same Struct found through more than one Base, as a shared virtual
+     * base, is not ambiguous; *ppInstance is then cast along the first Base
+     * declared.
+     *
+     * If ppInstance is not NULL, then *ppInstance must be an instance of
+     * this Struct, and is cast to an instance of the Struct which declares
+     * the returned Methods, so that it can be passed to their Invoke()
+     * methods, or set to NULL if some Base along the way is not castable.
+     *
+     * @param pName is the name of the Methods to look up
+     * @param ppInstance if not NULL, gives an instance of this Struct to be
+     *        cast to an instance of the Struct which declares the returned
+     *        Methods
+     * @return the Methods with the given name, which is empty if there are
+     *         none, in which case *ppInstance is left unchanged
+     **/
+    MethodOverloads LookupMethods(const char *pName, void **ppInstance = 0)
+        const;
+
+    /**
+     * Resolves a call to a Method declared by this Struct, by finding the
+     * Method with the given name whose arguments have exactly the given
+     * Types, as compared by Equals().  Methods with an ellipsis only match
+     * their declared arguments.  The Methods of base Structs are not
+     * searched; LookupMethod() does that.
+     *
+     * @param pName is the name of the Method to look up
+     * @param argumentCount is the number of arguments of the Method
+     * @param pArgumentTypes gives the Type of each of the arguments
+     * @return the Method of this Struct with the given name and argument
+     *         Types, or NULL if this Struct declares no such Method
+     **/
+    virtual const Method *LookupDeclaredMethod
+        (const char *pName, u32 argumentCount, 
+         const Xrtti::Type * const *pArgumentTypes) const = 0;
+
+    /**
+     * Resolves a call to a Method of this Struct or of any of its base
+     * Structs, by finding the Method with the given name whose arguments
+     * have exactly the given Types.  Only the Methods returned by
+     * LookupMethods() for the same name are candidates, so that, as in C++,
+     * a Method of this Struct hides all base Methods of the same name,
+     * whatever their arguments.
+     *
+     * @param pName is the name of the Method to look up
+     * @param argumentCount is the number of arguments of the Method
+     * @param pArgumentTypes gives the Type of each of the arguments
+     * @param ppInstance if not NULL, gives an instance of this Struct to be
+     *        cast to an instance of the Struct which declares the returned
+     *        Method, as for LookupMethods()
+     * @return the Method with the given name and argument Types, or NULL if
+     *         there is no such Method, in which case *ppInstance is left
+     *         unchanged
+     **/
+    const Method *LookupMethod(const char *pName, u32 argumentCount,
+                               const Xrtti::Type * const *pArgumentTypes,
+                               void **ppInstance = 0) const;
+};
+
+
+/** **************************************************************************
+ * MethodOverloads is a set of Methods of a single Struct which share the
+ * same name, as returned by Struct::LookupMethods().  It only refers to
+ * Methods owned by the Struct, and so is cheap to copy, and remains valid
+ * for as long as the Struct does.
+ ************************************************************************** **/
+class MethodOverloads
+{
+public:
+
+    /**
+     * Constructs an empty set of Methods.
+     **/
+    MethodOverloads()
+        : methodCountM(0), pMethodsM(0)
+    {
+    }
+
+    /**
+     * Constructs a set of Methods.
+     *
+     * @param methodCount is the number of Methods in the set
+     * @param pMethods is the array of Methods in the set, which must remain
+     *        valid for as long as this object is used
+     **/
+    MethodOverloads(u32 methodCount, const Method * const *pMethods)
+        : methodCountM(methodCount), pMethodsM(pMethods)
+    {
+    }
+
+    /**
+     * Returns the number of Methods in the set.
+     *
+     * @return the number of Methods in the set, which is zero if no Method
+     *         was found
+     **/
+    u32 GetMethodCount() const
+    {
+        return methodCountM;
+    }
+
+    /**
+     * Returns a Method in the set.
+     *
+     * @param index is the number of the Method to return
+     * @return a Method in the set.
+     **/
+    const Method &GetMethod(u32 index) const
+    {
+        return *(pMethodsM[index]);
+    }
+
+private:
+
+    u32 methodCountM;
+
+    const Method * const *pMethodsM;
 };
 
 
@@ -998,6 +1410,61 @@ public:
      *         as a bitfield
      **/
     virtual u32 GetBitfieldBitCount() const = 0;
+
+    /**
+     * If the field was declared as a bitfield, then this will return the
+     * size in bytes (1, 2, 4, or 8) of the storage unit which holds its
+     * bits.  This is 0 if the field is not a bitfield, or if its layout
+     * is not known, in which case GetBits() and SetBits() must NOT be
+     * called.
+     *
+     * @return the size in bytes of the storage unit holding the bitfield,
+     *         or 0 if the bitfield's layout is not known
+     **/
+    virtual u32 GetBitfieldStorageSize() const = 0;
+
+    /**
+     * Returns the offset in bytes from the beginning of the containing
+     * Structure to the storage unit holding this bitfield.  This is only
+     * meaningful if GetBitfieldStorageSize() returns nonzero.
+     *
+     * @return the offset in bytes of the storage unit holding this bitfield
+     **/
+    virtual u32 GetBitfieldOffset() const = 0;
+
+    /**
+     * Returns the position of the lowest bit of this bitfield within its
+     * storage unit, when the storage unit is read as a native-endian
+     * unsigned integer.  This is only meaningful if
+     * GetBitfieldStorageSize() returns nonzero.
+     *
+     * @return the shift of this bitfield within its storage unit
+     **/
+    virtual u32 GetBitfieldShift() const = 0;
+
+    /**
+     * Returns the bits of this bitfield within the given instance object,
+     * shifted down so that the lowest bit of the bitfield is bit 0.  The
+     * bits are not sign extended, even if the bitfield's type is signed.
+     * This may only be called if GetBitfieldStorageSize() returns nonzero.
+     *
+     * @param pInstance is an object of the type of the context containing
+     *        this field
+     * @return the bits of this bitfield
+     **/
+    virtual u64 GetBits(void *pInstance) const = 0;
+
+    /**
+     * Sets the bits of this bitfield within the given instance object,
+     * leaving every other bit of its storage unit unchanged.  Only the low
+     * GetBitfieldBitCount() bits of [value] are used.  This may only be
+     * called if GetBitfieldStorageSize() returns nonzero.
+     *
+     * @param pInstance is an object of the type of the context containing
+     *        this field
+     * @param value is the value to set the bits of this bitfield to
+     **/
+    virtual void SetBits(void *pInstance, u64 value) const = 0;
     
     /**
      * Returns true if the offset of this field within its containing
@@ -1046,9 +1513,88 @@ public:
      *         or assigned to change the value of the field.
      **/
     virtual void *Get(void *pInstance) const = 0;
+
+    /**
+     * The type of the function returned by GetGetThunk().
+     **/
+    typedef void *(*GetThunk)(void *pInstance);
+
+    /**
+     * Returns the function which Get() calls, so that a caller which gets
+     * this Field from many instances can call it directly, without the
+     * virtual call to Get() in between.
+     *
+     * @return the function which Get() calls, or NULL if this Field is not
+     *         accessible
+     **/
+    virtual GetThunk GetGetThunk() const = 0;
 };
 
 
+/** **************************************************************************
+ * FieldLayout is a plain 16 byte description of one Field, as returned by
+ * Structure::GetFieldLayout().  Each value is the same as that of the
+ * corresponding Field or Type method, except as noted.
+ ************************************************************************** **/
+typedef struct FieldLayout
+{
+    /** **********************************************************************
+     * These are the bits of flags
+     ********************************************************************** **/
+    enum Flag
+    {
+        Flag_HasOffset                   = 0x01,
+        Flag_Accessible                  = 0x02,
+        Flag_Static                      = 0x04,
+        Flag_Bitfield                    = 0x08,
+        Flag_Const                       = 0x10,
+        Flag_Volatile                    = 0x20,
+        Flag_Reference                   = 0x40
+    };
+
+    /**
+     * The offset in bytes of the Field, or of the storage unit of a
+     * bitfield, if Flag_HasOffset is set
+     **/
+    u32 offset;
+
+    /**
+     * The size in bytes of the Field, or of the storage unit of a bitfield,
+     * or 0 if it is not known
+     **/
+    u32 size;
+
+    /**
+     * The number of bits of a bitfield.  Otherwise, the number of elements
+     * held in place by the leading Array dimensions of the Field's Type
+     * (0 if any is unbounded), or 1 if its Type does not begin with an
+     * Array.
+     **/
+    u32 extent;
+
+    /**
+     * The Type::BaseType of the Field's Type
+     **/
+    u8 baseType;
+
+    /**
+     * The number of Pointers of the Field's Type
+     **/
+    u8 pointerDepth;
+
+    /**
+     * The shift of a bitfield within its storage unit, as returned by
+     * Field::GetBitfieldShift()
+     **/
+    u8 bitShift;
+
+    /**
+     * The Flag bits which apply to the Field
+     **/
+    u8 flags;
+} FieldLayout;
+
+
 /** **************************************************************************
  * Argument represents a single argument in a constructor or function
  * signature.
@@ -1438,6 +1984,37 @@ public:
      *         NULL if the containing Structure is anonymous
      **/
     virtual void *Invoke(void **pArgumentValues) const = 0;
+
+    /**
+     * The type of the function returned by GetInvokeThunk().
+     **/
+    typedef void *(*InvokeThunk)(void **pArgumentValues);
+
+    /**
+     * Returns the function which Invoke() calls, so that a caller which
+     * constructs many instances can call it directly, without the virtual
+     * call to Invoke() in between.
+     *
+     * @return the function which Invoke() calls, or NULL if this
+     *         Constructor is not invokeable
+     **/
+    virtual InvokeThunk GetInvokeThunk() const = 0;
+
+    /**
+     * Invokes this constructor on the given memory, without allocating
+     * anything, and returns the constructed instance.  The memory must be
+     * at least as large and as aligned as the GetSizeof() and GetAlignof()
+     * of the containing Structure, and the instance must be destroyed with
+     * its DestroyAt() method.  If this constructor is not invokeable, this
+     * method must not be called.
+     *
+     * @param pMemory is the memory to construct the instance in
+     * @param pArgumentValues is an array of pointers to the arguments to
+     *        pass to this constructor, just as for Invoke()
+     * @return the constructed instance, which is at pMemory
+     **/
+    virtual void *ConstructAt(void *pMemory, 
+                              void **pArgumentValues) const = 0;
 };
 
 
@@ -1550,9 +2127,190 @@ public:
      **/
     virtual void Invoke(void *pInstance, void *pReturnValue, 
                         void **pArgumentValues) const = 0;
+
+    /**
+     * The type of the function returned by GetInvokeThunk().
+     **/
+    typedef void (*InvokeThunk)(void *pInstance, void *pReturnValue,
+                                void **pArgumentValues);
+
+    /**
+     * Returns the function which Invoke() calls, so that a caller which
+     * invokes this method many times can call it directly, without the
+     * virtual call to Invoke() in between.
+     *
+     * @return the function which Invoke() calls, or NULL if this method is
+     *         not invokeable
+     **/
+    virtual InvokeThunk GetInvokeThunk() const = 0;
+
+    /**
+     * Returns true if this method can be invoked on an array of instances
+     * at once.  This is only so if xrttigen was run with -b when generating
+     * the Xrtti code for this method; otherwise, InvokeBatch() invokes
+     * nothing, and returns false.
+     *
+     * @return true if this method can be invoked on an array of instances
+     *         at once
+     **/
+    virtual bool IsBatchInvokeable() const = 0;
+
+    /**
+     * Invokes this method on each of an array of instances of the class
+     * represented by the Class containing this Method.  The loop over the
+     * instances runs inside the generated code, which calls the method
+     * directly, so that the cost of Invoke() is paid once per batch instead
+     * of once per instance.  If IsBatchInvokeable() returns false, this
+     * invokes nothing and returns false; Invoke() must be called for each
+     * instance instead.
+     *
+     * @param pInstances is the first instance to invoke this method on
+     * @param count is the number of instances to invoke this method on
+     * @param stride is the distance in bytes from each instance to the next;
+     *        for an array of instances, this is their sizeof
+     * @param pReturnValues is an array of [count] return values, in which
+     *        the return value of the invocation on each instance is stored,
+     *        or NULL if the return values are not wanted.  For a method
+     *        which returns a reference, this is an array of pointers.  If
+     *        the method has no return value, then this argument is ignored.
+     * @param pArgumentValues is an array of pointers, one per argument of
+     *        this method, each to an array of [count] values of that
+     *        argument; the invocation on each instance is passed the value
+     *        at that instance's index in each array.  For a pointer
+     *        argument, its array is an array of the pointers themselves.
+     * @return true if this method was invoked on the instances, false if
+     *         IsBatchInvokeable() returns false
+     **/
+    virtual bool InvokeBatch(void *pInstances, u32 count, u32 stride,
+                             void *pReturnValues,
+                             void **pArgumentValues) const = 0;
+
+    /**
+     * The type of the function returned by GetDirectInvoke(); it must be
+     * cast to its actual type, given by GetDirectInvokeType(), before it
+     * is called.
+     **/
+    typedef void (*DirectInvoke)();
+
+    /**
+     * Returns a function which invokes this method with its arguments
+     * passed by value, just as a direct call would pass them, rather than
+     * through an array of pointers.  Its actual type is R (*)(void *pInstance,
+     * A1, A2, ...) where R is the return type of this method, and A1, A2,
+     * ... are the types of its arguments.  This is meant to be used through
+     * Bind(), which checks that type.
+     *
+     * @return a function which invokes this method with its arguments
+     *         passed by value, or NULL if there is none
+     **/
+    virtual DirectInvoke GetDirectInvoke() const = 0;
+
+    /**
+     * Returns the type_info of the actual type of the function returned by
+     * GetDirectInvoke().
+     *
+     * @return the type_info of the actual type of the function returned by
+     *         GetDirectInvoke(), or NULL if there is no such function, or
+     *         if xrttigen was run with -n to generate code without C++ RTTI
+     **/
+    virtual const std::type_info *GetDirectInvokeType() const = 0;
+
+#if __cplusplus >= 201103L
+    /**
+     * Binds this method to a C++ function type, so that it can then be
+     * invoked with arguments of those types, which are passed just as they
+     * would be to a direct call.  The function type is checked once, here,
+     * against the types of the arguments and return value of this method,
+     * which must match exactly, for example:
+     *
+     * BoundMethod<int (int, const Foo &)> bound = 
+     *     pMethod->Bind<int (int, const Foo &)>();
+     * if (bound.IsBound()) {
+     *     int result = bound(pInstance, 1, foo);
+     * }
+     *
+     * @return the bound method, which is not bound (see
+     *         BoundMethod::IsBound()) if this method is not invokeable, if
+     *         it was generated without C++ RTTI, or if Signature does not
+     *         match its types
+     **/
+    template <typename Signature>
+    BoundMethod<Signature> Bind() const;
+#endif
+};
+
+
+#if __cplusplus >= 201103L
+/** **************************************************************************
+ * BoundMethod is a Method bound to the C++ function type given by its
+ * Signature, as returned by Method::Bind().  Calling it calls the Method
+ * through a single indirect call with its arguments passed by value, and
+ * so costs about as much as a call through a function pointer.
+ ************************************************************************** **/
+template <typename R, typename... Args>
+class BoundMethod<R (Args...)>
+{
+public:
+
+    /**
+     * Constructs a BoundMethod which is not bound.
+     **/
+    BoundMethod()
+        : pInvokeM(0)
+    {
+    }
+
+    /**
+     * Returns true if this BoundMethod is bound to a Method, and so may be
+     * called.
+     *
+     * @return true if this BoundMethod is bound to a Method
+     **/
+    bool IsBound() const
+    {
+        return pInvokeM;
+    }
+
+    /**
+     * Invokes the Method on an instance of the class represented by the
+     * Class containing it.
+     *
+     * @param pInstance is the instance of the class to invoke the Method on
+     * @param args are the arguments to pass to the Method
+     * @return the return value of the Method
+     **/
+    R operator ()(void *pInstance, Args... args) const
+    {
+        return (*pInvokeM)(pInstance, args...);
+    }
+
+private:
+
+    friend class Method;
+
+    typedef R (*Invoke)(void *, Args...);
+
+    Invoke pInvokeM;
 };
 
 
+template <typename Signature>
+BoundMethod<Signature> Method::Bind() const
+{
+    BoundMethod<Signature> bound;
+
+    const std::type_info *pType = this->GetDirectInvokeType();
+    if (pType && 
+        (*pType == typeid(typename BoundMethod<Signature>::Invoke))) {
+        bound.pInvokeM = (typename BoundMethod<Signature>::Invoke) 
+            this->GetDirectInvoke();
+    }
+
+    return bound;
+}
+#endif
+
+
 /** **************************************************************************
  * Type represents a C++ type.  Each Type may have a number of Pointers,
  * each of which describes the properties of one level of pointer indirection
@@ -1683,6 +2441,55 @@ public:
      * @return the ArrayOrPointer object at the given index.
      **/
     virtual const ArrayOrPointer &GetArrayOrPointer(u32 index) const = 0;
+
+    /**
+     * Returns true if this Type object can report the size of a value of
+     * the described C++ type via the GetSizeof() method, false if it cannot.
+     * void, functions, unbounded arrays, and incomplete or unnameable
+     * structures have no size.
+     *
+     * @return true if this Type object can report the size of a value of
+     *         the described C++ type via the GetSizeof() method
+     **/
+    virtual bool HasSizeof() const = 0;
+
+    /**
+     * Returns the size of a value of this Type in memory, as would be the
+     * result of a sizeof() operation on the C++ type described by this Type.
+     * As with sizeof(), the size of a reference is the size of what it
+     * refers to.  This is only valid if HasSizeof() returns true.
+     *
+     * @return the size of a value of this Type in memory
+     **/
+    virtual u32 GetSizeof() const = 0;
+
+    /**
+     * Returns the alignment of a value of this Type in memory, that is, the
+     * boundary which its address must be a multiple of.  This is only valid
+     * if HasSizeof() returns true.
+     *
+     * @return the alignment of a value of this Type in memory
+     **/
+    virtual u32 GetAlignof() const = 0;
+
+    /**
+     * Returns the canonical Type of this Type.  Every compiled Type is
+     * interned by the registry when it is registered, so that compiled
+     * Types which are structurally identical, from any generated file,
+     * share one canonical Type.  Two Types with the same canonical Type are
+     * always Equals(), but two Types which are Equals() may have different
+     * canonical Types.  For example, a Type which has not been interned,
+     * such as any parsed Type, or a compiled Type generated with the -s
+     * option which has not been registered yet, is its own canonical Type.
+     * So a test of canonical Types may only be used to shortcut Equals(),
+     * never in place of it.  The canonical Type of a compiled Type may
+     * change when a shared library containing generated code is unloaded,
+     * so callers must not keep a canonical Type from a library which may be
+     * unloaded.
+     *
+     * @return the canonical Type of this Type
+     **/
+    virtual const Type &GetCanonical() const = 0;
 };
 
 
@@ -1714,6 +2521,18 @@ public:
      * @return the type of this context
      **/
     virtual Type GetType() const = 0;
+
+    /**
+     * Returns the size of one element at this level of the Type: the
+     * distance in bytes between consecutive elements of an Array, or
+     * between consecutive objects that a Pointer may point to.  Stepping a
+     * byte pointer by this much is the same as incrementing a C++ pointer
+     * to the element.  This is 0 if the element has no size (see
+     * Type::HasSizeof()).
+     *
+     * @return the size of one element at this level of the Type, or 0
+     **/
+    virtual u32 GetElementStride() const = 0;
 };
 
 
@@ -1993,6 +2812,69 @@ public:
      * @return an EnumerationValue of this Enumeration
      **/
     virtual const EnumerationValue &GetValue(u32 index) const = 0;
+
+    /**
+     * Looks up the name of a value of this Enumeration.  If more than one
+     * EnumerationValue has the value, the name of the first one declared is
+     * returned.
+     *
+     * @param value is the value to look up
+     * @return the name of the value, or NULL if this Enumeration has no
+     *         EnumerationValue with that value
+     **/
+    virtual const char *LookupName(s32 value) const = 0;
+
+    /**
+     * Looks up the value of an EnumerationValue of this Enumeration by name.
+     *
+     * @param pName is the name of the EnumerationValue to look up
+     * @param pValue returns the value of the EnumerationValue, if it is found
+     * @return true if this Enumeration has an EnumerationValue with the given
+     *         name, false if not, in which case *pValue is left unchanged
+     **/
+    virtual bool LookupValue(const char *pName, s32 *pValue) const = 0;
+
+    /**
+     * Returns the number of flags of this Enumeration: EnumerationValues
+     * whose value has exactly one bit set.
+     *
+     * @return the number of flags of this Enumeration, at most 32
+     **/
+    virtual u32 GetFlagCount() const = 0;
+
+    /**
+     * Returns a flag of this Enumeration.  Flags are in order of the bit
+     * that they set, lowest first, and if more than one EnumerationValue
+     * sets the same bit, only the first one declared is a flag.
+     *
+     * @param index is the number of the flag to return
+     * @return a flag of this Enumeration
+     **/
+    virtual const EnumerationValue &GetFlag(u32 index) const = 0;
+
+    /**
+     * Returns true if this Enumeration appears to be a set of bit flags: it
+     * has at least one flag, and every one of its values is either zero or
+     * made up only of the bits of its flags.  This is a guess; a short
+     * enum such as { a, b, c } looks like a set of flags too.
+     *
+     * @return true if this Enumeration appears to be a set of bit flags
+     **/
+    virtual bool IsFlags() const = 0;
+
+    /**
+     * Decomposes a value into the flags of this Enumeration whose bits it
+     * has set, in the order of GetFlag().
+     *
+     * @param value is the value to decompose
+     * @param pFlags returns the flags whose bits are set in value, and must
+     *        have room for GetFlagCount() of them
+     * @param pRemainder if not NULL, returns the bits of value which are not
+     *        the bit of any flag
+     * @return the number of flags returned in pFlags
+     **/
+    u32 DecomposeFlags(s32 value, const EnumerationValue **pFlags,
+                       s32 *pRemainder = 0) const;
 };
 
 
@@ -2189,6 +3071,256 @@ public:
 };
 
 
+/** **************************************************************************
+ * Allocator provides the memory for the objects created by the Structure
+ * Create() and CreateArray() methods which take one, instead of global new.
+ * An Allocator is not thread safe; each thread should use its own.
+ ************************************************************************** **/
+class Allocator
+{
+public:
+
+    /**
+     * Destructor
+     **/
+    virtual ~Allocator() { }
+
+    /**
+     * Allocates memory.
+     *
+     * @param size is the number of bytes to allocate
+     * @param alignment is the alignment of the memory to allocate, which is
+     *        always a power of two
+     * @return the allocated memory, or NULL if it could not be allocated
+     **/
+    virtual void *Allocate(u32 size, u32 alignment) = 0;
+
+    /**
+     * Frees memory returned by Allocate().
+     *
+     * @param pMemory is the memory to free
+     * @param size is the number of bytes which were allocated
+     **/
+    virtual void Free(void *pMemory, u32 size) = 0;
+};
+
+
+/** **************************************************************************
+ * ArenaAllocator is an Allocator which allocates by advancing a pointer
+ * through large chunks of memory, and which frees nothing until Reset() or
+ * its destruction frees everything at once.  Objects created from an
+ * ArenaAllocator may be deleted, which destroys them but does not free their
+ * memory, or if they need no destruction, simply left for Reset().
+ ************************************************************************** **/
+class ArenaAllocator : public Allocator
+{
+public:
+
+    /**
+     * Constructs an ArenaAllocator; no memory is allocated until the first
+     * call to Allocate().
+     *
+     * @param chunkSize is the size of each chunk of memory which the arena
+     *        allocates from; larger allocations get a chunk of their own
+     **/
+    ArenaAllocator(u32 chunkSize = 64 * 1024);
+
+    /**
+     * Destructor, which frees all memory allocated from this arena.  No
+     * destructors of objects created in the arena are called.
+     **/
+    virtual ~ArenaAllocator();
+
+    virtual void *Allocate(u32 size, u32 alignment);
+
+    /**
+     * Does nothing; memory is only freed by Reset() or destruction.
+     **/
+    virtual void Free(void *pMemory, u32 size);
+
+    /**
+     * Frees all memory allocated from this arena at once, keeping one chunk
+     * to allocate from again.  No destructors of objects created in the
+     * arena are called.
+     **/
+    void Reset();
+
+private:
+
+    // Not copyable
+    ArenaAllocator(const ArenaAllocator &);
+    ArenaAllocator &operator =(const ArenaAllocator &);
+
+    u32 chunkSizeM;
+
+    // The chunks, most recently allocated first
+    void *pChunksM;
+
+    // The unallocated memory of the most recently allocated chunk
+    char *pNextM, *pEndM;
+};
+
+
+/** **************************************************************************
+ * PoolAllocator is an Allocator of single objects of one Structure, which
+ * keeps freed objects' memory in a free list to allocate again.  Memory is
+ * allocated in slabs of many objects, and only freed on destruction of the
+ * PoolAllocator.  It can allocate nothing larger than one object, and so
+ * cannot be used with CreateArray() for more than one element.
+ ************************************************************************** **/
+class PoolAllocator : public Allocator
+{
+public:
+
+    /**
+     * Constructs a PoolAllocator for objects of the given Structure, which
+     * must have a size (see Structure::HasSizeof()).  No memory is
+     * allocated until the first call to Allocate().
+     *
+     * @param structure is the Structure which this pool allocates
+     * @param slabCount is the number of objects allocated at once whenever
+     *        the free list is empty
+     **/
+    PoolAllocator(const Structure &structure, u32 slabCount = 256);
+
+    /**
+     * Destructor, which frees all memory allocated by this pool.  No
+     * destructors of objects still allocated from the pool are called.
+     **/
+    virtual ~PoolAllocator();
+
+    /**
+     * Allocates the memory of one object, or returns NULL if [size] or
+     * [alignment] is larger than that of the pool's Structure.
+     **/
+    virtual void *Allocate(u32 size, u32 alignment);
+
+    virtual void Free(void *pMemory, u32 size);
+
+private:
+
+    // Not copyable
+    PoolAllocator(const PoolAllocator &);
+    PoolAllocator &operator =(const PoolAllocator &);
+
+    u32 sizeM, alignmentM, blockSizeM, slabCountM;
+
+    // The slabs, most recently allocated first
+    void *pSlabsM;
+
+    // Memory which has been freed, or not yet allocated
+    void *pFreeM;
+};
+
+
+/** **************************************************************************
+ * FieldPath is a path to a Field nested within instances of a Structure,
+ * such as "a.b.c[3].d", which is resolved once, when the FieldPath is
+ * constructed, into byte offsets separated by pointer dereferences.  It can
+ * then be evaluated against any number of instances with no lookups and no
+ * virtual calls.
+ *
+ * A path is the name of a Field of the Structure, followed by any number of
+ * ".name" or "->name" elements, each naming a Field of the Structure (or
+ * pointer to Structure) reached so far, and "[index]" elements, each
+ * indexing the array or pointer reached so far.  A Field which is a C++
+ * reference is followed to what it refers to.  Fields of Bases may be named,
+ * except through virtual Bases; static Fields and bitfields may not be.
+ ************************************************************************** **/
+class FieldPath
+{
+public:
+
+    /**
+     * Resolves a path against a Structure.  If the path could not be
+     * resolved, IsValid() returns false.
+     *
+     * @param structure is the Structure whose instances the path is
+     *        evaluated against
+     * @param pPath is the path to resolve
+     **/
+    FieldPath(const Structure &structure, const char *pPath);
+
+    /**
+     * Destructor
+     **/
+    ~FieldPath();
+
+    /**
+     * Returns true if the path was resolved, and so may be evaluated.  If
+     * this method returns false, then the other methods of this class must
+     * NOT be called.
+     *
+     * @return true if the path was resolved
+     **/
+    bool IsValid() const
+    {
+        return (offsetCountM != 0);
+    }
+
+    /**
+     * Returns the last Field named by the path.
+     *
+     * @return the last Field named by the path
+     **/
+    const Field &GetField() const
+    {
+        return *pFieldM;
+    }
+
+    /**
+     * Returns the number of the Arrays and Pointers of the Type of the last
+     * Field named by the path which were indexed by the path after it.  The
+     * value that Evaluate() points to has the Type of that Field, without
+     * that many of its first Arrays and Pointers.
+     *
+     * @return the number of Arrays and Pointers indexed after the last Field
+     **/
+    u32 GetIndexCount() const
+    {
+        return indexCountM;
+    }
+
+    /**
+     * Returns a pointer to the value which the path reaches within the
+     * given instance.
+     *
+     * @param pInstance is an instance of the Structure that the path was
+     *        resolved against
+     * @return a pointer to the value which the path reaches, or NULL if a
+     *         NULL pointer was dereferenced on the way to it
+     **/
+    void *Evaluate(void *pInstance) const
+    {
+        char *p = ((char *) pInstance) + pOffsetsM[0];
+
+        for (u32 i = 1; i < offsetCountM; i++) {
+            if (!(p = * (char **) p)) {
+                return 0;
+            }
+            p += pOffsetsM[i];
+        }
+
+        return p;
+    }
+
+private:
+
+    // Not copyable
+    FieldPath(const FieldPath &);
+    FieldPath &operator =(const FieldPath &);
+
+    // The offsets; a pointer is dereferenced in between each of them
+    u32 offsetCountM;
+
+    u32 *pOffsetsM;
+
+    const Field *pFieldM;
+
+    u32 indexCountM;
+};
+
+
 /** **************************************************************************
  * Utility helper functions
  ************************************************************************** **/
@@ -2282,6 +3414,76 @@ const Context *LookupContext(const char *pFullName);
  **/
 const Structure *LookupStructure(const std::type_info &typeinfo);
 
+/**
+ * Registers the compiled Contexts of every shared library loaded since
+ * the Xrtti registry last looked for them, whose Xrtti code was generated
+ * by xrttigen with the -s option.  LookupContext() and LookupStructure()
+ * look for them whenever they would otherwise return NULL, so this is only
+ * needed for GetContextCount(), GetContext() and the class hierarchy
+ * functions to see such a library before anything in it has been looked
+ * up.  Contexts generated without -s are registered when their library is
+ * loaded, and never need this.
+ *
+ * @return true if any Contexts were registered, false if not
+ **/
+bool RefreshContexts();
+
+/**
+ * Returns true if a compiled Structure derives, directly or indirectly,
+ * from another one.  A Structure is not a subclass of itself.  This takes
+ * constant time, regardless of the depth of the class hierarchy or of the
+ * number of registered Contexts.
+ *
+ * @param structure is the compiled Structure which may be a subclass
+ * @param base is the compiled Structure which may be its ancestor
+ * @return true if base is a direct or indirect base of structure, false if
+ *         not or if either is not a registered compiled Structure
+ **/
+bool IsSubclassOf(const Structure &structure, const Structure &base);
+
+/**
+ * Returns the number of registered compiled Structures which directly
+ * derive from a compiled Structure; this is the inverse of
+ * Structure::GetBaseCount().
+ *
+ * @param structure is the compiled Structure to get the subclass count of
+ * @return the number of registered compiled Structures which have
+ *         structure as a direct base
+ **/
+u32 GetDerivedCount(const Structure &structure);
+
+/**
+ * Returns a compiled Structure which directly derives from a compiled
+ * Structure.
+ *
+ * @param structure is the compiled Structure to get a subclass of
+ * @param index is the index of the subclass to get; this value must be less
+ *        than the value returned by GetDerivedCount(structure)
+ * @return the index'th direct subclass of structure, or NULL if Contexts
+ *         have been unregistered such that there no longer is one
+ **/
+const Structure *GetDerived(const Structure &structure, u32 index);
+
+/**
+ * Casts an instance of a compiled Structure to an instance of one of its
+ * direct or indirect base classes.  This has the same result as calling
+ * Base::CastSubclass() for each Base on the way from one to the other, but
+ * the way is only looked for once for each pair of Structures, and then
+ * cached.  If there are no virtual bases on the way, the cast is then a
+ * single pointer offset; otherwise, Base::CastSubclass() is only called for
+ * the virtual bases.
+ *
+ * @param pObject is the instance to cast; it must be an instance of the
+ *        type described by from
+ * @param from is the compiled Structure describing the type of pObject
+ * @param to is the compiled Structure describing the type to cast to
+ * @return pObject cast to an instance of the type described by to, or NULL
+ *         if pObject is NULL, or if to is not a base of from, or is an
+ *         ambiguous base of from, or can only be reached from from via a
+ *         Base which is not castable (see Base::IsCastable())
+ **/
+void *Cast(void *pObject, const Structure &from, const Structure &to);
+
 }; // namespace Xrtti
 
 
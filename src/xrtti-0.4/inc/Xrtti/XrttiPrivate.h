@@ -32,6 +32,9 @@
 #ifndef XRTTI_PRIVATE_H
 #define XRTTI_PRIVATE_H
 
+#if __cplusplus >= 201103L
+#include <type_traits>
+#endif
 #include <Xrtti/Xrtti.h>
 
 
@@ -45,12 +48,69 @@ typedef void *(CompiledCreate)();
 typedef void *(CompiledCreateArray)(u32);
 typedef void (CompiledDelete)(void *);
 typedef void (CompiledDeleteArray)(void *);
+typedef void *(CompiledConstructAt)(void *);
+typedef void (CompiledDestroyAt)(void *);
+typedef void *(CompiledCopyConstruct)(void *, const void *);
+typedef void *(CompiledMoveConstruct)(void *, void *);
+typedef void (CompiledCopyAssign)(void *, const void *);
+typedef void (CompiledMoveAssign)(void *, void *);
 typedef void *(CompiledGet)(void *);
+typedef void (CompiledClearBits)(void *);
 typedef void (CompiledDestructorInvoke)(void *);
 typedef void *(CompiledConstructorInvoke)(void **);
+typedef void *(CompiledConstructorConstructAt)(void *, void **);
 typedef void (CompiledMethodInvoke)(void *, void *, void **);
+typedef void (CompiledMethodInvokeBatch)(void *, u32, u32, void *, void **);
 typedef void *(CompiledCast)(void *);
 
+// One slot of the open-addressed table which xrttigen generates for each
+// Struct, which resolves a Method from its name and argument Types.  The
+// hash is CompiledStruct::HashOverload() of the Method, and empty slots
+// have a NULL pMethod.
+typedef struct CompiledOverload
+{
+    u32 hash;
+    Method *pMethod;
+} CompiledOverload;
+
+// The alignment of T, which xrttigen generates for each Structure and Type.
+// This does not declare a member of type T, which an abstract T cannot be.
+template <typename T> struct CompiledAlignof
+{
+#if __cplusplus >= 201103L
+    static const u32 value = alignof(T);
+#else
+    static const u32 value = __alignof__(T);
+#endif
+};
+
+// The type traits of a Structure, which xrttigen generates for each
+// Structure; from CompiledTraits when compiled as C++11 or later, and
+// otherwise all of them or none, depending upon whether it is plain old data
+typedef enum CompiledTrait
+{
+    CompiledTrait_TriviallyCopyable               = 0x01,
+    CompiledTrait_TriviallyDestructible           = 0x02,
+    CompiledTrait_TriviallyDefaultConstructible   = 0x04,
+    CompiledTrait_StandardLayout                  = 0x08,
+    CompiledTrait_Pod                             = 0x0F
+} CompiledTrait;
+
+#if __cplusplus >= 201103L
+template <typename T> struct CompiledTraits
+{
+    static const u32 value =
+        (std::is_trivially_copyable<T>::value ? 
+         CompiledTrait_TriviallyCopyable : 0) |
+        (std::is_trivially_destructible<T>::value ? 
+         CompiledTrait_TriviallyDestructible : 0) |
+        (std::is_trivially_default_constructible<T>::value ?
+         CompiledTrait_TriviallyDefaultConstructible : 0) |
+        (std::is_standard_layout<T>::value ? 
+         CompiledTrait_StandardLayout : 0);
+};
+#endif
+
 class CompiledArgument;
 class CompiledArray;
 class CompiledBase;
@@ -159,29 +219,45 @@ public:
 
     CompiledStructure(const char *pName, const char *pFullName, 
                       const Context *pContext, bool isIncomplete,
-                      bool hasSizeof, u32 size, bool hasStructureName,
+                      bool hasSizeof, u32 size, u32 alignment,
+                      bool hasStructureName,
                       AccessType accessType,
                       const std::type_info *pTypeInfo,
                       u32 baseCount, Base **pBases,
                       u32 friendCount, Structure **pFriends,
                       u32 fieldCount, Field **pFields, 
+                      Field **pFieldsByName,
+                      FieldLayout *pFieldLayout,
                       bool isAnonymous, u32 constructorCount,
                       Constructor **pConstructors,
                       Destructor *pDestructor,
                       CompiledCreate *pCreate, 
                       CompiledCreateArray *pCreateArray,
                       CompiledDelete *pDelete,
-                      CompiledDeleteArray *pDeleteArray)
+                      CompiledDeleteArray *pDeleteArray,
+                      CompiledConstructAt *pConstructAt,
+                      CompiledDestroyAt *pDestroyAt,
+                      u32 traits,
+                      CompiledCopyConstruct *pCopyConstruct,
+                      CompiledMoveConstruct *pMoveConstruct,
+                      CompiledCopyAssign *pCopyAssign,
+                      CompiledMoveAssign *pMoveAssign)
         : superM(pName, pFullName, pContext), isIncompleteM(isIncomplete),
-          hasSizeofM(hasSizeof), sizeofM(size), 
+          hasSizeofM(hasSizeof), sizeofM(size), alignofM(alignment),
           hasStructureNameM(hasStructureName), accessTypeM(accessType),
           pTypeInfoM(pTypeInfo), baseCountM(baseCount), pBasesM(pBases),
           friendCountM(friendCount), pFriendsM(pFriends), 
           fieldCountM(fieldCount), pFieldsM(pFields),
+          pFieldsByNameM(pFieldsByName), pFieldLayoutM(pFieldLayout),
           isAnonymousM(isAnonymous), constructorCountM(constructorCount),
           pConstructorsM(pConstructors), pDestructorM(pDestructor), 
           pCreateM(pCreate), pCreateArrayM(pCreateArray),
-          pDeleteM(pDelete), pDeleteArrayM(pDeleteArray)
+          pDeleteM(pDelete), pDeleteArrayM(pDeleteArray),
+          pConstructAtM(pConstructAt), pDestroyAtM(pDestroyAt),
+          traitsM(traits),
+          pCopyConstructM(pCopyConstruct), pMoveConstructM(pMoveConstruct),
+          pCopyAssignM(pCopyAssign), pMoveAssignM(pMoveAssign),
+          fieldLayoutStateM(0)
     {
     }
 
@@ -224,6 +300,11 @@ public:
         return sizeofM;
     }
 
+    virtual u32 GetAlignof() const
+    {
+        return alignofM;
+    }
+
     virtual bool HasStructureName() const
     {
         return hasStructureNameM;
@@ -260,6 +341,10 @@ public:
 
     virtual const Field &GetField(u32 index) const;
 
+    virtual const FieldLayout *GetFieldLayout() const;
+
+    virtual const Field *LookupDeclaredField(const char *pName) const;
+
     virtual bool IsAnonymous() const
     {
         return isAnonymousM;
@@ -309,6 +394,54 @@ public:
         (*pDeleteArrayM)(pInstanceArray);
     }
 
+    virtual void *ConstructAt(void *pMemory) const
+    {
+        return (*pConstructAtM)(pMemory);
+    }
+
+    virtual void DestroyAt(void *pInstance) const
+    {
+        (*pDestroyAtM)(pInstance);
+    }
+
+    virtual bool IsCopyConstructible() const
+    {
+        return pCopyConstructM;
+    }
+
+    virtual bool IsCopyAssignable() const
+    {
+        return pCopyAssignM;
+    }
+
+    virtual bool IsTriviallyCopyable() const
+    {
+        return (traitsM & CompiledTrait_TriviallyCopyable);
+    }
+
+    virtual bool IsTriviallyDestructible() const
+    {
+        return (traitsM & CompiledTrait_TriviallyDestructible);
+    }
+
+    virtual bool IsTriviallyDefaultConstructible() const
+    {
+        return (traitsM & CompiledTrait_TriviallyDefaultConstructible);
+    }
+
+    virtual bool IsStandardLayout() const
+    {
+        return (traitsM & CompiledTrait_StandardLayout);
+    }
+
+    virtual void *CopyConstruct(void *pMemory, const void *pOther) const;
+
+    virtual void *MoveConstruct(void *pMemory, void *pOther) const;
+
+    virtual void CopyAssign(void *pInstance, const void *pOther) const;
+
+    virtual void MoveAssign(void *pInstance, void *pOther) const;
+
 private:
 
     CompiledContext superM;
@@ -319,6 +452,8 @@ private:
 
     u32 sizeofM;
 
+    u32 alignofM;
+
     bool hasStructureNameM;
 
     AccessType accessTypeM;
@@ -337,6 +472,16 @@ private:
     
     Field **pFieldsM;
 
+    // The same Fields, sorted by name
+    Field **pFieldsByNameM;
+
+    // Generated from everything known about the Fields at compile time;
+    // the layout of their bitfields is filled in by LayoutBitfields()
+    FieldLayout *pFieldLayoutM;
+
+    // Called once, by the first GetFieldLayout()
+    void LayoutBitfields() const;
+
     bool isAnonymousM;
 
     u32 constructorCountM;
@@ -352,6 +497,24 @@ private:
     void (*pDeleteM)(void *);
 
     void (*pDeleteArrayM)(void *);
+
+    void *(*pConstructAtM)(void *);
+
+    void (*pDestroyAtM)(void *);
+
+    // CompiledTrait bits
+    u32 traitsM;
+
+    void *(*pCopyConstructM)(void *, const void *);
+
+    void *(*pMoveConstructM)(void *, void *);
+
+    void (*pCopyAssignM)(void *, const void *);
+
+    void (*pMoveAssignM)(void *, void *);
+
+    // Guards LayoutBitfields()
+    mutable u32 fieldLayoutStateM;
 };
 
 
@@ -360,9 +523,11 @@ class CompiledBase : public Base
 public:
 
     CompiledBase(AccessType accessType, bool isVirtual, 
-                 Structure *pStructure, CompiledCast *pCompiledCast)
+                 Structure *pStructure, CompiledCast *pCompiledCast,
+                 bool hasOffset, u32 offset)
         : accessTypeM(accessType), isVirtualM(isVirtual), 
-          pStructureM(pStructure), pCompiledCastM(pCompiledCast)
+          pStructureM(pStructure), pCompiledCastM(pCompiledCast),
+          hasOffsetM(hasOffset), offsetM(offset)
     {
     }
 
@@ -393,6 +558,16 @@ public:
         return (*pCompiledCastM)(pObject);
     }
 
+    virtual bool HasOffset() const
+    {
+        return hasOffsetM;
+    }
+
+    virtual u32 GetOffset() const
+    {
+        return offsetM;
+    }
+
 private:
 
     AccessType accessTypeM;
@@ -402,6 +577,10 @@ private:
     Structure *pStructureM;
 
     CompiledCast *pCompiledCastM;
+
+    bool hasOffsetM;
+
+    u32 offsetM;
 };
 
 
@@ -411,24 +590,38 @@ public:
 
     CompiledUnion(const char *pName, const char *pFullName, 
                   const Context *pContext, bool isIncomplete,
-                  bool hasSizeof, u32 size, bool hasStructureName,
+                  bool hasSizeof, u32 size, u32 alignment,
+                  bool hasStructureName,
                   AccessType accessType,
                   const std::type_info *pTypeInfo,
                   u32 baseCount, Base **pBases,
                   u32 friendCount, Structure **pFriends,
                   u32 fieldCount, Field **pFields, 
+                  Field **pFieldsByName,
+                  FieldLayout *pFieldLayout,
                   bool isAnonymous, u32 constructorCount,
                   Constructor **pConstructors,
                   Destructor *pDestructor,
                   CompiledCreate *pCreate, 
                   CompiledCreateArray *pCreateArray,
                   CompiledDelete *pDelete,
-                  CompiledDeleteArray *pDeleteArray)
-        : superM(pName, pFullName, pContext, isIncomplete, hasSizeof, size, 
-                 hasStructureName, accessType, pTypeInfo, baseCount, pBases,
-                 friendCount, pFriends, fieldCount, pFields, isAnonymous,
+                  CompiledDeleteArray *pDeleteArray,
+                  CompiledConstructAt *pConstructAt,
+                  CompiledDestroyAt *pDestroyAt,
+                  u32 traits,
+                  CompiledCopyConstruct *pCopyConstruct,
+                  CompiledMoveConstruct *pMoveConstruct,
+                  CompiledCopyAssign *pCopyAssign,
+                  CompiledMoveAssign *pMoveAssign)
+        : superM(pName, pFullName, pContext, isIncomplete, hasSizeof, size,
+                 alignment, hasStructureName, accessType, pTypeInfo,
+                 baseCount, pBases, friendCount, pFriends, fieldCount,
+                 pFields, pFieldsByName, pFieldLayout,
+                 isAnonymous,
                  constructorCount, pConstructors, pDestructor, pCreate,
-                 pCreateArray, pDelete, pDeleteArray)
+                 pCreateArray, pDelete, pDeleteArray, pConstructAt,
+                 pDestroyAt, traits, pCopyConstruct,
+                 pMoveConstruct, pCopyAssign, pMoveAssign)
     {
     }
 
@@ -466,6 +659,11 @@ public:
         return superM.GetSizeof();
     }
 
+    virtual u32 GetAlignof() const
+    {
+        return superM.GetAlignof();
+    }
+
     virtual bool HasStructureName() const
     {
         return superM.HasStructureName();
@@ -511,6 +709,16 @@ public:
         return superM.GetField(index);
     }
 
+    virtual const FieldLayout *GetFieldLayout() const
+    {
+        return superM.GetFieldLayout();
+    }
+
+    virtual const Field *LookupDeclaredField(const char *pName) const
+    {
+        return superM.LookupDeclaredField(pName);
+    }
+
     virtual bool IsAnonymous() const
     {
         return superM.IsAnonymous();
@@ -566,6 +774,66 @@ public:
         return superM.DeleteArray(pInstanceArray);
     }
 
+    virtual void *ConstructAt(void *pMemory) const
+    {
+        return superM.ConstructAt(pMemory);
+    }
+
+    virtual void DestroyAt(void *pInstance) const
+    {
+        return superM.DestroyAt(pInstance);
+    }
+
+    virtual bool IsCopyConstructible() const
+    {
+        return superM.IsCopyConstructible();
+    }
+
+    virtual bool IsCopyAssignable() const
+    {
+        return superM.IsCopyAssignable();
+    }
+
+    virtual bool IsTriviallyCopyable() const
+    {
+        return superM.IsTriviallyCopyable();
+    }
+
+    virtual bool IsTriviallyDestructible() const
+    {
+        return superM.IsTriviallyDestructible();
+    }
+
+    virtual bool IsTriviallyDefaultConstructible() const
+    {
+        return superM.IsTriviallyDefaultConstructible();
+    }
+
+    virtual bool IsStandardLayout() const
+    {
+        return superM.IsStandardLayout();
+    }
+
+    virtual void *CopyConstruct(void *pMemory, const void *pOther) const
+    {
+        return superM.CopyConstruct(pMemory, pOther);
+    }
+
+    virtual void *MoveConstruct(void *pMemory, void *pOther) const
+    {
+        return superM.MoveConstruct(pMemory, pOther);
+    }
+
+    virtual void CopyAssign(void *pInstance, const void *pOther) const
+    {
+        return superM.CopyAssign(pInstance, pOther);
+    }
+
+    virtual void MoveAssign(void *pInstance, void *pOther) const
+    {
+        return superM.MoveAssign(pInstance, pOther);
+    }
+
 private:
 
     CompiledStructure superM;
@@ -578,27 +846,44 @@ public:
 
     CompiledStruct(const char *pName, const char *pFullName, 
                    const Context *pContext, bool isIncomplete,
-                   bool hasSizeof, u32 size, bool hasStructureName,
+                   bool hasSizeof, u32 size, u32 alignment,
+                   bool hasStructureName,
                    AccessType accessType,
                    const std::type_info *pTypeInfo,
                    u32 baseCount, Base **pBases,
                    u32 friendCount, Structure **pFriends,
                    u32 fieldCount, Field **pFields, 
+                   Field **pFieldsByName,
+                   FieldLayout *pFieldLayout,
                    bool isAnonymous, u32 constructorCount,
                    Constructor **pConstructors,
                    Destructor *pDestructor,
                    CompiledCreate *pCreate, 
                    CompiledCreateArray *pCreateArray,
                    CompiledDelete *pDelete,
-                   CompiledDeleteArray *pDeleteArray, bool isAbstract,
-                   u32 methodCount, Method **pMethods)
-        : superM(pName, pFullName, pContext, isIncomplete, hasSizeof, size, 
-                 hasStructureName, accessType, pTypeInfo, baseCount, pBases,
-                 friendCount, pFriends, fieldCount, pFields, isAnonymous,
+                   CompiledDeleteArray *pDeleteArray,
+                   CompiledConstructAt *pConstructAt,
+                   CompiledDestroyAt *pDestroyAt,
+                   u32 traits,
+                   CompiledCopyConstruct *pCopyConstruct,
+                   CompiledMoveConstruct *pMoveConstruct,
+                   CompiledCopyAssign *pCopyAssign,
+                   CompiledMoveAssign *pMoveAssign, bool isAbstract,
+                   u32 methodCount, Method **pMethods,
+                   Method **pMethodsByName, u32 overloadCapacity,
+                   CompiledOverload *pOverloads)
+        : superM(pName, pFullName, pContext, isIncomplete, hasSizeof, size,
+                 alignment, hasStructureName, accessType, pTypeInfo,
+                 baseCount, pBases, friendCount, pFriends, fieldCount,
+                 pFields, pFieldsByName, pFieldLayout,
+                 isAnonymous,
                  constructorCount, pConstructors, pDestructor, pCreate,
-                 pCreateArray, pDelete, pDeleteArray),
+                 pCreateArray, pDelete, pDeleteArray, pConstructAt,
+                 pDestroyAt, traits, pCopyConstruct,
+                 pMoveConstruct, pCopyAssign, pMoveAssign),
           isAbstractM(isAbstract), methodCountM(methodCount),
-          pMethodsM(pMethods)
+          pMethodsM(pMethods), pMethodsByNameM(pMethodsByName),
+          overloadCapacityM(overloadCapacity), pOverloadsM(pOverloads)
     {
     }
 
@@ -636,6 +921,11 @@ public:
         return superM.GetSizeof();
     }
 
+    virtual u32 GetAlignof() const
+    {
+        return superM.GetAlignof();
+    }
+
     virtual bool HasStructureName() const
     {
         return superM.HasStructureName();
@@ -681,6 +971,16 @@ public:
         return superM.GetField(index);
     }
 
+    virtual const FieldLayout *GetFieldLayout() const
+    {
+        return superM.GetFieldLayout();
+    }
+
+    virtual const Field *LookupDeclaredField(const char *pName) const
+    {
+        return superM.LookupDeclaredField(pName);
+    }
+
     virtual bool IsAnonymous() const
     {
         return superM.IsAnonymous();
@@ -736,6 +1036,66 @@ public:
         return superM.DeleteArray(pInstanceArray);
     }
 
+    virtual void *ConstructAt(void *pMemory) const
+    {
+        return superM.ConstructAt(pMemory);
+    }
+
+    virtual void DestroyAt(void *pInstance) const
+    {
+        return superM.DestroyAt(pInstance);
+    }
+
+    virtual bool IsCopyConstructible() const
+    {
+        return superM.IsCopyConstructible();
+    }
+
+    virtual bool IsCopyAssignable() const
+    {
+        return superM.IsCopyAssignable();
+    }
+
+    virtual bool IsTriviallyCopyable() const
+    {
+        return superM.IsTriviallyCopyable();
+    }
+
+    virtual bool IsTriviallyDestructible() const
+    {
+        return superM.IsTriviallyDestructible();
+    }
+
+    virtual bool IsTriviallyDefaultConstructible() const
+    {
+        return superM.IsTriviallyDefaultConstructible();
+    }
+
+    virtual bool IsStandardLayout() const
+    {
+        return superM.IsStandardLayout();
+    }
+
+    virtual void *CopyConstruct(void *pMemory, const void *pOther) const
+    {
+        return superM.CopyConstruct(pMemory, pOther);
+    }
+
+    virtual void *MoveConstruct(void *pMemory, void *pOther) const
+    {
+        return superM.MoveConstruct(pMemory, pOther);
+    }
+
+    virtual void CopyAssign(void *pInstance, const void *pOther) const
+    {
+        return superM.CopyAssign(pInstance, pOther);
+    }
+
+    virtual void MoveAssign(void *pInstance, void *pOther) const
+    {
+        return superM.MoveAssign(pInstance, pOther);
+    }
+
     // Struct methods ---------------------------------------------------------
 
     virtual bool IsAbstract() const
@@ -750,6 +1110,17 @@ public:
 
     virtual const Method &GetMethod(u32 index) const;
 
+    virtual MethodOverloads LookupDeclaredMethods(const char *pName) const;
+
+    virtual const Method *LookupDeclaredMethod
+        (const char *pName, u32 argumentCount, 
+         const Xrtti::Type * const *pArgumentTypes) const;
+
+    // Hashes a Method name and argument Types into the key of the
+    // overload table; Types which are Equals() hash equally
+    static u32 HashOverload(const char *pName, u32 argumentCount,
+                            const Xrtti::Type * const *pArgumentTypes);
+
 private:
 
     CompiledStructure superM;
@@ -759,6 +1130,14 @@ private:
     u32 methodCountM;
 
     Method **pMethodsM;
+
+    // The same Methods, sorted by name, and then in declaration order
+    Method **pMethodsByNameM;
+
+    // A power of two, or zero if there are no Methods
+    u32 overloadCapacityM;
+
+    CompiledOverload *pOverloadsM;
 };
 
 
@@ -768,26 +1147,43 @@ public:
     
     CompiledClass(const char *pName, const char *pFullName, 
                   const Context *pContext, bool isIncomplete,
-                  bool hasSizeof, u32 size, bool hasStructureName,
+                  bool hasSizeof, u32 size, u32 alignment,
+                  bool hasStructureName,
                   AccessType accessType,
                   const std::type_info *pTypeInfo,
                   u32 baseCount, Base **pBases,
                   u32 friendCount, Structure **pFriends,
                   u32 fieldCount, Field **pFields, 
+                  Field **pFieldsByName,
+                  FieldLayout *pFieldLayout,
                   bool isAnonymous, u32 constructorCount,
                   Constructor **pConstructors,
                   Destructor *pDestructor,
                   CompiledCreate *pCreate, 
                   CompiledCreateArray *pCreateArray,
                   CompiledDelete *pDelete,
-                  CompiledDeleteArray *pDeleteArray, bool isAbstract,
-                  u32 methodCount, Method **pMethods)
+                  CompiledDeleteArray *pDeleteArray,
+                  CompiledConstructAt *pConstructAt,
+                  CompiledDestroyAt *pDestroyAt,
+                  u32 traits,
+                  CompiledCopyConstruct *pCopyConstruct,
+                  CompiledMoveConstruct *pMoveConstruct,
+                  CompiledCopyAssign *pCopyAssign,
+                  CompiledMoveAssign *pMoveAssign, bool isAbstract,
+                  u32 methodCount, Method **pMethods,
+                  Method **pMethodsByName, u32 overloadCapacity,
+                  CompiledOverload *pOverloads)
         : superM(pName, pFullName, pContext, isIncomplete, hasSizeof, size,
-                 hasStructureName, accessType, pTypeInfo, baseCount, pBases,
-                 friendCount, pFriends, fieldCount, pFields, isAnonymous,
+                 alignment, hasStructureName, accessType, pTypeInfo,
+                 baseCount, pBases, friendCount, pFriends, fieldCount,
+                 pFields, pFieldsByName, pFieldLayout,
+                 isAnonymous,
                  constructorCount, pConstructors, pDestructor, pCreate,
-                 pCreateArray, pDelete, pDeleteArray, isAbstract, methodCount,
-                 pMethods)
+                 pCreateArray, pDelete, pDeleteArray, pConstructAt,
+                 pDestroyAt, traits, pCopyConstruct,
+                 pMoveConstruct, pCopyAssign, pMoveAssign, isAbstract,
+                 methodCount, pMethods, pMethodsByName, overloadCapacity,
+                 pOverloads)
     {
     }
 
@@ -825,6 +1221,11 @@ public:
         return superM.GetSizeof();
     }
 
+    virtual u32 GetAlignof() const
+    {
+        return superM.GetAlignof();
+    }
+
     virtual bool HasStructureName() const
     {
         return superM.HasStructureName();
@@ -870,6 +1271,16 @@ public:
         return superM.GetField(index);
     }
 
+    virtual const FieldLayout *GetFieldLayout() const
+    {
+        return superM.GetFieldLayout();
+    }
+
+    virtual const Field *LookupDeclaredField(const char *pName) const
+    {
+        return superM.LookupDeclaredField(pName);
+    }
+
     virtual bool IsAnonymous() const
     {
         return superM.IsAnonymous();
@@ -925,6 +1336,66 @@ public:
         return superM.DeleteArray(pInstanceArray);
     }
 
+    virtual void *ConstructAt(void *pMemory) const
+    {
+        return superM.ConstructAt(pMemory);
+    }
+
+    virtual void DestroyAt(void *pInstance) const
+    {
+        return superM.DestroyAt(pInstance);
+    }
+
+    virtual bool IsCopyConstructible() const
+    {
+        return superM.IsCopyConstructible();
+    }
+
+    virtual bool IsCopyAssignable() const
+    {
+        return superM.IsCopyAssignable();
+    }
+
+    virtual bool IsTriviallyCopyable() const
+    {
+        return superM.IsTriviallyCopyable();
+    }
+
+    virtual bool IsTriviallyDestructible() const
+    {
+        return superM.IsTriviallyDestructible();
+    }
+
+    virtual bool IsTriviallyDefaultConstructible() const
+    {
+        return superM.IsTriviallyDefaultConstructible();
+    }
+
+    virtual bool IsStandardLayout() const
+    {
+        return superM.IsStandardLayout();
+    }
+
+    virtual void *CopyConstruct(void *pMemory, const void *pOther) const
+    {
+        return superM.CopyConstruct(pMemory, pOther);
+    }
+
+    virtual void *MoveConstruct(void *pMemory, void *pOther) const
+    {
+        return superM.MoveConstruct(pMemory, pOther);
+    }
+
+    virtual void CopyAssign(void *pInstance, const void *pOther) const
+    {
+        return superM.CopyAssign(pInstance, pOther);
+    }
+
+    virtual void MoveAssign(void *pInstance, void *pOther) const
+    {
+        return superM.MoveAssign(pInstance, pOther);
+    }
+
     // Struct methods ---------------------------------------------------------
 
     virtual bool IsAbstract() const
@@ -942,6 +1413,19 @@ public:
         return superM.GetMethod(index);
     }
 
+    virtual MethodOverloads LookupDeclaredMethods(const char *pName) const
+    {
+        return superM.LookupDeclaredMethods(pName);
+    }
+
+    virtual const Method *LookupDeclaredMethod
+        (const char *pName, u32 argumentCount, 
+         const Xrtti::Type * const *pArgumentTypes) const
+    {
+        return superM.LookupDeclaredMethod
+            (pName, argumentCount, pArgumentTypes);
+    }
+
 private:
 
     CompiledStruct superM;
@@ -999,10 +1483,13 @@ public:
 
     CompiledField(AccessType accessType, Context *pContext,
                   const char *pName, bool isStatic, Type *pType,
-                  u32 bitCount, bool hasOffset, u32 offset, CompiledGet *pGet)
+                  u32 bitCount, bool hasOffset, u32 offset, CompiledGet *pGet,
+                  u32 containerSize, CompiledClearBits *pClearBits)
         : superM(accessType, pContext, pName, isStatic), pTypeM(pType),
           bitCountM(bitCount), hasOffsetM(hasOffset), offsetM(offset),
-          pGetM(pGet)
+          pGetM(pGet), containerSizeM(containerSize), 
+          pClearBitsM(pClearBits), bitsStateM(0), bitStorageSizeM(0), 
+          bitOffsetM(0), bitShiftM(0), bitMaskM(0)
     {
     }
 
@@ -1035,6 +1522,28 @@ public:
         return bitCountM;
     }
 
+    virtual u32 GetBitfieldStorageSize() const
+    {
+        this->ProbeBits();
+        return bitStorageSizeM;
+    }
+
+    virtual u32 GetBitfieldOffset() const
+    {
+        this->ProbeBits();
+        return bitOffsetM;
+    }
+
+    virtual u32 GetBitfieldShift() const
+    {
+        this->ProbeBits();
+        return bitShiftM;
+    }
+
+    virtual u64 GetBits(void *pInstance) const;
+
+    virtual void SetBits(void *pInstance, u64 value) const;
+
     virtual const Type &GetType() const;
 
     virtual bool HasOffset() const
@@ -1057,6 +1566,11 @@ public:
         return (*pGetM)(pInstance);
     }
 
+    virtual GetThunk GetGetThunk() const
+    {
+        return pGetM;
+    }
+
 private:
 
     CompiledMember superM;
@@ -1070,6 +1584,26 @@ private:
     u32 offsetM;
 
     void *(*pGetM)(void *);
+
+    u32 containerSizeM;
+
+    CompiledClearBits *pClearBitsM;
+
+    // Finds the storage unit of the bitfield, the first time that it is
+    // needed, by clearing it within an otherwise all-ones Structure, and
+    // seeing which bits were cleared
+    void ProbeBits() const;
+
+    mutable u32 bitsStateM;
+
+    mutable u32 bitStorageSizeM;
+
+    mutable u32 bitOffsetM;
+
+    mutable u32 bitShiftM;
+
+    // The bits of the bitfield within its storage unit
+    mutable u64 bitMaskM;
 };
 
 
@@ -1326,10 +1860,11 @@ public:
                         const char *pName, bool isStatic,
                         ConstructorSignature *pSignature,
                         const char **pArgumentNames,
-                        CompiledConstructorInvoke *pConstructorInvoke)
+                        CompiledConstructorInvoke *pConstructorInvoke,
+                        CompiledConstructorConstructAt *pConstructAt)
         : superM(accessType, pContext, pName, isStatic),
           pSignatureM(pSignature), pArgumentNamesM(pArgumentNames),
-          pConstructorInvokeM(pConstructorInvoke)
+          pConstructorInvokeM(pConstructorInvoke), pConstructAtM(pConstructAt)
     {
     }
 
@@ -1377,6 +1912,16 @@ public:
         return (*pConstructorInvokeM)(pArgumentValues);
     }
 
+    virtual InvokeThunk GetInvokeThunk() const
+    {
+        return pConstructorInvokeM;
+    }
+
+    virtual void *ConstructAt(void *pMemory, void **pArgumentValues) const
+    {
+        return (*pConstructAtM)(pMemory, pArgumentValues);
+    }
+
 private:
 
     CompiledMember superM;
@@ -1386,6 +1931,8 @@ private:
     const char **pArgumentNamesM;
 
     void *(*pConstructorInvokeM)(void **);
+
+    void *(*pConstructAtM)(void *, void **);
 };
 
 
@@ -1398,12 +1945,17 @@ public:
                    bool isConst, bool isVirtual, bool isPureVirtual,
                    CompiledMethodSignature *pSignature, 
 				   const char **pArgumentNames,
-                   CompiledMethodInvoke *pMethodInvoke)
+                   CompiledMethodInvoke *pMethodInvoke,
+                   CompiledMethodInvokeBatch *pMethodInvokeBatch,
+                   DirectInvoke pDirectInvoke,
+                   const std::type_info *pDirectInvokeType)
         : superM(accessType, pContext, pName, isStatic), 
           isOperatorMethodM(isOperatorMethod), isConstM(isConst),
           isVirtualM(isVirtual), isPureVirtualM(isPureVirtual),
           pSignatureM(pSignature), pArgumentNamesM(pArgumentNames),
-          pMethodInvokeM(pMethodInvoke)
+          pMethodInvokeM(pMethodInvoke), 
+          pMethodInvokeBatchM(pMethodInvokeBatch), 
+          pDirectInvokeM(pDirectInvoke), pDirectInvokeTypeM(pDirectInvokeType)
     {
     }
 
@@ -1472,6 +2024,40 @@ public:
         (*pMethodInvokeM)(pInstance, pReturnValue, pArgumentValues);
     }
 
+    virtual InvokeThunk GetInvokeThunk() const
+    {
+        return pMethodInvokeM;
+    }
+
+    virtual bool IsBatchInvokeable() const
+    {
+        return pMethodInvokeBatchM;
+    }
+
+    virtual bool InvokeBatch(void *pInstances, u32 count, u32 stride,
+                             void *pReturnValues, 
+                             void **pArgumentValues) const
+    {
+        if (!pMethodInvokeBatchM) {
+            return false;
+        }
+
+        (*pMethodInvokeBatchM)(pInstances, count, stride, pReturnValues,
+                               pArgumentValues);
+
+        return true;
+    }
+
+    virtual DirectInvoke GetDirectInvoke() const
+    {
+        return pDirectInvokeM;
+    }
+
+    virtual const std::type_info *GetDirectInvokeType() const
+    {
+        return pDirectInvokeTypeM;
+    }
+
 private:
 
     CompiledMember superM;
@@ -1483,6 +2069,12 @@ private:
     const char **pArgumentNamesM;
 
     CompiledMethodInvoke *pMethodInvokeM;
+
+    CompiledMethodInvokeBatch *pMethodInvokeBatchM;
+
+    DirectInvoke pDirectInvokeM;
+
+    const std::type_info *pDirectInvokeTypeM;
 };
 
 
@@ -1490,12 +2082,14 @@ class CompiledType : public Type
 {
 public:
 
+    // A [size] of 0 means that the Type has no size
     CompiledType(BaseType baseType, bool isConst, bool isVolatile,
-                 bool isReference, u32 arrayOrPointerCount,
-                 ArrayOrPointer **pArrayOrPointers)
+                 bool isReference, u32 size, u32 alignment,
+                 u32 arrayOrPointerCount, ArrayOrPointer **pArrayOrPointers)
         : baseTypeM(baseType), isConstM(isConst), isVolatileM(isVolatile),
-          isReferenceM(isReference), arrayOrPointerCountM(arrayOrPointerCount), 
-          pArrayOrPointersM(pArrayOrPointers)
+          isReferenceM(isReference), sizeofM(size), alignofM(alignment),
+          arrayOrPointerCountM(arrayOrPointerCount), 
+          pArrayOrPointersM(pArrayOrPointers), pCanonicalM(0)
     {
     }
 
@@ -1528,6 +2122,43 @@ public:
 
     virtual const ArrayOrPointer &GetArrayOrPointer(u32 index) const;
 
+    virtual bool HasSizeof() const
+    {
+        return (sizeofM != 0);
+    }
+
+    virtual u32 GetSizeof() const
+    {
+        return sizeofM;
+    }
+
+    virtual u32 GetAlignof() const
+    {
+        return alignofM;
+    }
+
+    virtual const Type &GetCanonical() const
+    {
+        return this->GetCanonical(*this);
+    }
+
+    // Returns the canonical Type of [type], which is either this Type or
+    // the Compiled Type which contains it; [type] is its own canonical Type
+    // until the registry has interned it, which it does as it registers it
+    const Type &GetCanonical(const Type &type) const
+    {
+        const Type *pCanonical = 
+            __atomic_load_n(&pCanonicalM, __ATOMIC_ACQUIRE);
+
+        return pCanonical ? *pCanonical : type;
+    }
+
+    // Only called by the registry, with its lock held
+    void SetCanonical(const Type *pCanonical)
+    {
+        __atomic_store_n(&pCanonicalM, pCanonical, __ATOMIC_RELEASE);
+    }
+
 private:
 
     BaseType baseTypeM;
@@ -1538,9 +2169,15 @@ private:
 
     bool isReferenceM;
 
+    u32 sizeofM;
+
+    u32 alignofM;
+
     u32 arrayOrPointerCountM;
 
     ArrayOrPointer **pArrayOrPointersM;
+
+    const Type *pCanonicalM;
 };
 
 
@@ -1548,9 +2185,17 @@ class CompiledPointer : public Pointer
 {
 public:
 
-    CompiledPointer(bool isConst, bool isVolatile)
-        : isConstM(isConst), isVolatileM(isVolatile)
+    CompiledPointer(bool isConst, bool isVolatile, u32 elementStride)
+        : isConstM(isConst), isVolatileM(isVolatile),
+          elementStrideM(elementStride)
+    {
+    }
+
+    // ArrayOrPointer methods -------------------------------------------------
+
+    virtual u32 GetElementStride() const
     {
+        return elementStrideM;
     }
 
     // Pointer methods --------------------------------------------------------
@@ -1570,17 +2215,27 @@ private:
     bool isConstM;
 
     bool isVolatileM;
+
+    u32 elementStrideM;
 };
 
 class CompiledArray : public Array
 {
 public:
 
-    CompiledArray(bool isUnbounded, u32 elementCount)
-        : isUnboundedM(isUnbounded), elementCountM(elementCount)
+    CompiledArray(bool isUnbounded, u32 elementCount, u32 elementStride)
+        : isUnboundedM(isUnbounded), elementCountM(elementCount),
+          elementStrideM(elementStride)
     {
     }
 
+    // ArrayOrPointer methods -------------------------------------------------
+
+    virtual u32 GetElementStride() const
+    {
+        return elementStrideM;
+    }
+
     // Array methods ----------------------------------------------------------
 
     virtual bool IsUnbounded() const
@@ -1598,6 +2253,8 @@ private:
     bool isUnboundedM;
 
     u32 elementCountM;
+
+    u32 elementStrideM;
 };
 
 
@@ -1607,9 +2264,17 @@ public:
 
     CompiledEnumeration(AccessType accessType, Context *pContext,
                         const char *pName, u32 valueCount,
-                        EnumerationValue **pValues)
+                        EnumerationValue **pValues,
+                        EnumerationValue **pValuesByName, bool isDense,
+                        s32 firstValue, u32 byValueCount,
+                        EnumerationValue **pValuesByValue, u32 flagCount,
+                        EnumerationValue **pFlags, bool isFlags)
         : accessTypeM(accessType), pContextM(pContext), pNameM(pName),
-          valueCountM(valueCount), pValuesM(pValues)
+          valueCountM(valueCount), pValuesM(pValues),
+          pValuesByNameM(pValuesByName), isDenseM(isDense),
+          firstValueM(firstValue), byValueCountM(byValueCount),
+          pValuesByValueM(pValuesByValue), flagCountM(flagCount),
+          pFlagsM(pFlags), isFlagsM(isFlags)
     {
     }
 
@@ -1637,6 +2302,22 @@ public:
 
     virtual const EnumerationValue &GetValue(u32 index) const;
 
+    virtual const char *LookupName(s32 value) const;
+
+    virtual bool LookupValue(const char *pName, s32 *pValue) const;
+
+    virtual u32 GetFlagCount() const
+    {
+        return flagCountM;
+    }
+
+    virtual const EnumerationValue &GetFlag(u32 index) const;
+
+    virtual bool IsFlags() const
+    {
+        return isFlagsM;
+    }
+
 private:
 
     AccessType accessTypeM;
@@ -1648,6 +2329,28 @@ private:
     u32 valueCountM;
 
     EnumerationValue **pValuesM;
+
+    // The same EnumerationValues, sorted by name
+    EnumerationValue **pValuesByNameM;
+
+    // If isDenseM, then pValuesByValueM is indexed by value - firstValueM,
+    // with NULL for each value which no EnumerationValue has; otherwise it
+    // has one entry for each distinct value, sorted by value.  Either way,
+    // the entry for a value is the first EnumerationValue declared with it.
+    bool isDenseM;
+
+    s32 firstValueM;
+
+    u32 byValueCountM;
+
+    EnumerationValue **pValuesByValueM;
+
+    // The flags, in order of their bit
+    u32 flagCountM;
+
+    EnumerationValue **pFlagsM;
+
+    bool isFlagsM;
 };
 
 
@@ -1685,12 +2388,13 @@ class CompiledTypeEnumeration : public TypeEnumeration
 public:
 
     CompiledTypeEnumeration(Type::BaseType /* baseType */, bool isConst,
-                            bool isVolatile, bool isReference,
-                            u32 arrayOrPointerCount,
+                            bool isVolatile, bool isReference, u32 size,
+                            u32 alignment, u32 arrayOrPointerCount,
                             ArrayOrPointer **pArrayOrPointers,
                             Enumeration *pEnumeration)
         : superM(BaseType_Enumeration, isConst, isVolatile,
-                 isReference, arrayOrPointerCount, pArrayOrPointers),
+                 isReference, size, alignment, arrayOrPointerCount,
+                 pArrayOrPointers),
           pEnumerationM(pEnumeration)
     {
     }
@@ -1727,6 +2431,26 @@ public:
         return superM.GetArrayOrPointer(index);
     }
 
+    virtual bool HasSizeof() const
+    {
+        return superM.HasSizeof();
+    }
+
+    virtual u32 GetSizeof() const
+    {
+        return superM.GetSizeof();
+    }
+
+    virtual u32 GetAlignof() const
+    {
+        return superM.GetAlignof();
+    }
+
+    virtual const Type &GetCanonical() const
+    {
+        return superM.GetCanonical(*this);
+    }
+
     // TypeEnumeration methods ------------------------------------------------
 
     virtual const Enumeration &GetEnumeration() const
@@ -1734,6 +2458,12 @@ public:
         return *pEnumerationM;
     }
 
+    // The CompiledType that this wraps
+    CompiledType &GetCompiledType()
+    {
+        return superM;
+    }
+
 private:
 
     CompiledType superM;
@@ -1747,12 +2477,13 @@ class CompiledTypeFunction : public TypeFunction
 public:
 
     CompiledTypeFunction(Type::BaseType /* baseType */, bool isConst,
-                         bool isVolatile, bool isReference,
-                         u32 arrayOrPointerCount, 
+                         bool isVolatile, bool isReference, u32 size,
+                         u32 alignment, u32 arrayOrPointerCount,
                          ArrayOrPointer **pArrayOrPointers,
                          MethodSignature *pSignature)
         : superM(BaseType_Function, isConst, isVolatile,
-                 isReference, arrayOrPointerCount, pArrayOrPointers),
+                 isReference, size, alignment, arrayOrPointerCount,
+                 pArrayOrPointers),
           pSignatureM(pSignature)
     {
     }
@@ -1789,6 +2520,26 @@ public:
         return superM.GetArrayOrPointer(index);
     }
 
+    virtual bool HasSizeof() const
+    {
+        return superM.HasSizeof();
+    }
+
+    virtual u32 GetSizeof() const
+    {
+        return superM.GetSizeof();
+    }
+
+    virtual u32 GetAlignof() const
+    {
+        return superM.GetAlignof();
+    }
+
+    virtual const Type &GetCanonical() const
+    {
+        return superM.GetCanonical(*this);
+    }
+
     // TypeFunction methods ---------------------------------------------------
 
     virtual const MethodSignature &GetSignature() const
@@ -1796,6 +2547,12 @@ public:
         return *pSignatureM;
     }
 
+    // The CompiledType that this wraps
+    CompiledType &GetCompiledType()
+    {
+        return superM;
+    }
+
 private:
 
     CompiledType superM;
@@ -1809,12 +2566,13 @@ class CompiledTypeStructure : public TypeStructure
 public:
     
     CompiledTypeStructure(Type::BaseType /* baseType */, bool isConst,
-                          bool isVolatile, bool isReference,
-                          u32 arrayOrPointerCount, 
+                          bool isVolatile, bool isReference, u32 size,
+                          u32 alignment, u32 arrayOrPointerCount,
                           ArrayOrPointer **pArrayOrPointers,
                           Structure *pStructure)
         : superM(BaseType_Structure, isConst, isVolatile,
-                 isReference, arrayOrPointerCount, pArrayOrPointers),
+                 isReference, size, alignment, arrayOrPointerCount,
+                 pArrayOrPointers),
           pStructureM(pStructure)
     {
     }
@@ -1851,6 +2609,26 @@ public:
         return superM.GetArrayOrPointer(index);
     }
 
+    virtual bool HasSizeof() const
+    {
+        return superM.HasSizeof();
+    }
+
+    virtual u32 GetSizeof() const
+    {
+        return superM.GetSizeof();
+    }
+
+    virtual u32 GetAlignof() const
+    {
+        return superM.GetAlignof();
+    }
+
+    virtual const Type &GetCanonical() const
+    {
+        return superM.GetCanonical(*this);
+    }
+
     // TypeStructure methods --------------------------------------------------
 
     virtual const Structure &GetStructure() const
@@ -1858,6 +2636,12 @@ public:
         return *pStructureM;
     }
 
+    // The CompiledType that this wraps
+    CompiledType &GetCompiledType()
+    {
+        return superM;
+    }
+
 private:
 
     CompiledType superM;
@@ -1869,10 +2653,87 @@ class CompiledRegister
 {
 public:
 
-    CompiledRegister(u32 contextCount, Context **pContexts);
+    // pHashes gives CompiledContextSet::Hash() of the full name of each of
+    // pContexts, as computed by xrttigen, so that registration does not have
+    // to hash any names itself.  pFingerprints gives four u32s for each of
+    // pContexts, making up its 128-bit structural fingerprint as computed by
+    // xrttigen, so that when a context has already been registered from
+    // another generated file, the two can be checked for equality without
+    // comparing them deeply; it may be NULL.  pTypes gives every Type of the
+    // generated file, and pTypeFingerprints four u32s for each of them,
+    // making up the 128-bit structural fingerprint by which the registry
+    // interns it.
+    CompiledRegister(u32 contextCount, Context **pContexts, 
+                     const u32 *pHashes, const u32 *pFingerprints,
+                     u32 typeCount, Type **pTypes, 
+                     const u32 *pTypeFingerprints);
+
+    // Unregisters the contexts, so that a shared library containing
+    // generated code can be unloaded; by the time this returns, no lookup
+    // can still be using any of them.  Callers must themselves stop using
+    // any of them that they have looked up.
+    ~CompiledRegister();
+
+private:
+
+    u32 contextCountM;
+
+    Context **pContextsM;
+
+    const u32 *pHashesM;
+
+    u32 typeCountM;
+
+    Type **pTypesM;
+
+    const u32 *pTypeFingerprintsM;
 };
 
 
+// The linker section into which code generated by xrttigen -s places one
+// CompiledRegistration per generated file, instead of registering through a
+// static CompiledRegister.  The name must be a valid C identifier so that
+// the linker defines __start_ and __stop_ symbols for it.
+#define XRTTI_REGISTRY_SECTION "xrtti_registry"
+
+// The name of the symbol which every shared object (and executable)
+// containing such code defines, giving the bounds of its section.  This is
+// weak, so that each object ends up with one, and has default visibility,
+// so that it can be looked up per object regardless of the visibility the
+// linker gives the __start_ and __stop_ symbols.
+#define XRTTI_REGISTRY_BOUNDS_SYMBOL "xrtti_registry_bounds"
+
+// The registration of all of the contexts of one generated file, placed in
+// XRTTI_REGISTRY_SECTION.  This is plain old data which is initialized
+// statically, so that nothing runs at load time; the registry finds it on
+// its first use, or, once its object has been loaded, on the first lookup
+// which misses or RefreshContexts().
+typedef struct CompiledRegistration
+{
+    u32 contextCount;
+
+    Context **pContexts;
+
+    const u32 *pHashes;
+
+    const u32 *pFingerprints;
+
+    u32 typeCount;
+
+    Type **pTypes;
+
+    const u32 *pTypeFingerprints;
+
+    // The __dso_handle of the object containing the generated file, so that
+    // its contexts are unregistered when it is unloaded, before its static
+    // objects are destroyed
+    void *pDsoHandle;
+
+    // Only written by the registry, while it holds its lock
+    u32 registered;
+} CompiledRegistration;
+
+
 class CompiledContextSet
 {
 public:
@@ -1885,11 +2746,76 @@ public:
 
     static const Structure *LookupStructure(const std::type_info &typeinfo);
 
+    // Registers the registration sections of libraries loaded since they
+    // were last searched, which is otherwise only done on first use and
+    // on a lookup which misses
+    static bool RefreshContexts();
+
+    // These answer from an index of the class hierarchy of every registered
+    // Structure, which is built on first use after any registration change
+    static bool IsSubclassOf(const Structure &structure, 
+                             const Structure &base);
+
+    static u32 GetDerivedCount(const Structure &structure);
+
+    static const Structure *GetDerived(const Structure &structure, u32 index);
+
+    // The path from each Structure to each other is computed on the first
+    // cast between them, and cached until the registry changes
+    static void *Cast(void *pObject, const Structure &from, 
+                      const Structure &to);
+
     static void RegisterContext(Context *pContext);
 
-    static void RegisterType(Type *pType);
+    static void RegisterContext(Context *pContext, u32 hash);
+
+    // Registers all of the contexts of one generated file at once; lookups
+    // may run concurrently with this and are never blocked by it.
+    // pFingerprints may be NULL, in which case a context which is already
+    // registered under the same full name is compared deeply instead.
+    static void RegisterContexts(u32 contextCount, Context **pContexts,
+                                 const u32 *pHashes, 
+                                 const u32 *pFingerprints);
+
+    // Unregisters contexts which were registered by RegisterContexts, and
+    // waits until no concurrent lookup can still be using them.  pHashes
+    // may be NULL, in which case the full names are hashed.
+    static void UnregisterContexts(u32 contextCount, Context **pContexts,
+                                   const u32 *pHashes);
+
+    // Registers and interns all of the Types of one generated file at once;
+    // each Type's fingerprint is four u32s of pFingerprints
+    static void RegisterTypes(u32 typeCount, Type **pTypes,
+                              const u32 *pFingerprints);
+
+    // Unregisters Types which were registered by RegisterTypes, giving any
+    // of them which was the canonical Type of others a new canonical Type,
+    // and waits until no concurrent reader can still be using them
+    static void UnregisterTypes(u32 typeCount, Type **pTypes,
+                                const u32 *pFingerprints);
+
+    // Does both of the above at once, waiting only once, for a
+    // CompiledRegister
+    static void Unregister(u32 contextCount, Context **pContexts,
+                           const u32 *pHashes, u32 typeCount, Type **pTypes,
+                           const u32 *pTypeFingerprints);
 
     static void RegisterEnumeration(Enumeration *pEnumeration);
+
+    // The hash function used for all registry indices (32-bit FNV-1a).  This
+    // is shared with xrttigen, which emits precomputed hashes of full names,
+    // and so must never change without regenerating all generated code.
+    static u32 Hash(const char *pString)
+    {
+        u32 hash = 2166136261UL;
+
+        while (*pString) {
+            hash ^= (unsigned char) *pString++;
+            hash *= 16777619UL;
+        }
+
+        return hash;
+    }
 };
 
 }; // namespace Xrtti
@@ -97,6 +97,16 @@ public:
         return !disableRttiM;
     }
 
+    bool GetSectionRegistration() const
+    {
+        return sectionRegistrationM;
+    }
+
+    bool GetBatchInvoke() const
+    {
+        return batchInvokeM;
+    }
+
     u32 GetHeaderCount() const
     {
         return vHeadersM.size();
@@ -146,6 +156,8 @@ private:
     std::vector<Clude *> vCludesM;
     std::vector<std::string> vHeadersM;
     bool disableRttiM;
+    bool sectionRegistrationM;
+    bool batchInvokeM;
     std::string outFileM;
     std::string tmpFileM;
     std::vector<std::string> vInputsM;
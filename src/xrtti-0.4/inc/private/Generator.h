@@ -210,6 +210,8 @@ protected:
 
     bool CanInvokeDefaultDestructor();
 
+    bool CanCopy(bool assign);
+
     virtual void EmitExtraDeclarations(FILE *fileOut);
 
     virtual void EmitExtraDefinitions(FILE *fileOut);
@@ -243,6 +245,8 @@ public:
 
     virtual void EmitXrttiAccess(FILE *fileOut);
 
+    virtual void EmitXrttiAccessStaticDefinitions(FILE *fileOut);
+
 protected:
 
     virtual const char *GetCompiledTypeName()
@@ -256,6 +260,8 @@ private:
 
     bool CanEmitCast();
 
+    bool CanEmitOffset();
+
     const Base &baseM;
 
     GeneratorStructure *pSubstructureM;
@@ -309,6 +315,9 @@ protected:
 
 private:
 
+    // Returns the number of slots in the overload table of the Struct
+    u32 GetOverloadCapacity();
+
     const Struct &structM;
     
     std::vector<GeneratorMethod *> vMethodsM;
@@ -370,6 +379,8 @@ public:
 
     virtual void EmitXrttiAccessStaticDefinitions(FILE *fileOut);
 
+    void EmitFieldLayout(FILE *fileOut, bool comma);
+
 protected:
 
     virtual const char *GetCompiledTypeName()
@@ -385,6 +396,10 @@ private:
 
     bool CanEmitGet();
 
+    bool CanEmitSizeof();
+
+    bool CanEmitClearBits();
+
     void EmitGet(FILE *fileOut);
 
     const Field &fieldM;
@@ -401,6 +416,8 @@ public:
 
     bool IsPointer();
 
+    bool IsReference();
+
     bool TypeIsConstNonPointer();
 
     u32 GetTypeNumber();
@@ -479,6 +496,16 @@ public:
 
     void EmitInvokeArguments(FILE *fileOut);
 
+    // Emits the parameter list of a direct invoke function, following its
+    // pThis parameter, and the arguments passed on from them
+    void EmitDirectInvokeParameters(FILE *fileOut);
+
+    void EmitDirectInvokeArguments(FILE *fileOut);
+
+    // Emits the arguments of a batch invoke function for the instance at
+    // index i, each taken from the array of values of that argument
+    void EmitBatchInvokeArguments(FILE *fileOut);
+
     void EmitTypedefs(FILE *fileOut);
 
     void EmitArgumentTypeList(FILE *fileOut);
@@ -512,6 +539,8 @@ public:
     
     u32 GetReturnTypeNumber();
 
+    std::string GetDirectInvokeReturnType();
+
     bool CanEmitReturnTypeAndArguments();
 
     void EmitTypedefs(FILE *fileOut);
@@ -643,9 +672,15 @@ protected:
 
 private:
 
+    void EmitBatchInvokeLoop(FILE *fileOut, bool storeReturn);
+
     const Method &methodM;
 
     GeneratorMethodSignature methodSignatureM;
+
+    bool batchInvokeM;
+
+    bool rttiM;
 };
 
 
@@ -664,6 +699,16 @@ public:
 
     void EmitTypedef(FILE *fileOut);
 
+    const char *GetBaseTypeName();
+
+    // Emits the size and alignment of the Type, and the element stride of
+    // each of its Arrays and Pointers, as taken by the generated code
+    virtual void EmitXrttiAccess(FILE *fileOut);
+
+    // True if the generated code can take the size of one element at Array
+    // or Pointer level [index] of the Type
+    bool HasElementStride(u32 index);
+
 protected:
 
     virtual void EmitPrerequisiteTypedefs(FILE * /* fileOut */)
@@ -689,10 +734,12 @@ protected:
 
 private:
 
-    const char *GetBaseTypeName();
-
     std::string GetCppTypeName();
 
+    // True if the Type without its first [index] Arrays and Pointers has a
+    // size
+    bool IsSized(u32 index);
+
     bool typedefEmittedM;
 
     const Type &typeM;
@@ -705,11 +752,22 @@ class GeneratorArrayOrPointer : public GeneratorObject
 {
 public:
 
-    GeneratorArrayOrPointer()
+    GeneratorArrayOrPointer(GeneratorType &type, u32 index)
+        : typeM(type), indexM(index)
     {
     }
 
     virtual ArrayOrPointer::Type GetType() = 0;
+
+protected:
+
+    void EmitElementStrideArgument(FILE *fileOut);
+
+private:
+
+    GeneratorType &typeM;
+
+    u32 indexM;
 };
 
 
@@ -717,8 +775,8 @@ class GeneratorArray : public GeneratorArrayOrPointer
 {
 public:
 
-    GeneratorArray(const Array &array)
-        : arrayM(array)
+    GeneratorArray(GeneratorType &type, u32 index, const Array &array)
+        : GeneratorArrayOrPointer(type, index), arrayM(array)
     {
     }
 
@@ -746,8 +804,8 @@ class GeneratorPointer : public GeneratorArrayOrPointer
 {
 public:
 
-    GeneratorPointer(const Pointer &pointer)
-        : pointerM(pointer)
+    GeneratorPointer(GeneratorType &type, u32 index, const Pointer &pointer)
+        : GeneratorArrayOrPointer(type, index), pointerM(pointer)
     {
     }
 
@@ -794,11 +852,22 @@ protected:
 
 private:
 
+    // Returns the number of the GeneratorEnumerationValue of value
+    u32 GetValueNumber(const EnumerationValue &value);
+
     const Enumeration &enumerationM;
 
     GeneratorContext *pContextM;
 
     std::vector<GeneratorEnumerationValue *> vValuesM;
+
+    // The index in vValuesM of the first EnumerationValue declared with
+    // each distinct value, sorted by value
+    std::vector<std::pair<s32, u32> > vByValueM;
+
+    // True if vByValueM is emitted as a table indexed by value, because
+    // few of the values between its first and last are missing
+    bool isDenseM;
 };
 
 
@@ -953,10 +1022,29 @@ public:
     static void EmitArrayArgument(FILE *fileOut, u32 count,
                                   const char *name, u32 number, bool comma);
 
+    // Emits the _<number>_<name>_by_name array of pointers to the given
+    // objects, which are (member name, object number) pairs, sorted by
+    // member name and then in the given order
+    static void EmitArrayByName
+        (FILE *fileOut, const char *type, const char *name, u32 number,
+         std::vector<std::pair<std::string, u32> > vMembers);
+
     static bool IsAccessible(const Context *pContext);
     static bool IsAccessible(const Member *pMember);
     static bool IsPod(const Context *pContext);
 
+    // Returns true if the structure can be copy constructed, or if
+    // [assign], copy assigned, from a const instance by the generated code,
+    // whether by a declared or an implicit copy constructor or assignment
+    static bool IsCopyable(const Structure *pStructure, bool assign);
+
+    // Computes the 128-bit structural fingerprint of the context into
+    // pFingerprint[0..3]; contexts with equal fingerprints are Equals()
+    static void GetFingerprint(const Context *pContext, u32 *pFingerprint);
+
+    // Likewise for a type, by which the registry interns it
+    static void GetFingerprint(const Type *pType, u32 *pFingerprint);
+
     static std::string GetTypeName(const Context *pContext);
 
 private:
@@ -970,6 +1058,7 @@ private:
     void EmitDeclarations(FILE *fileOut);
     void EmitDefinitions(FILE *fileOut);
     void EmitRegister(FILE *fileOut);
+    void EmitSectionRegistration(FILE *fileOut);
 
     Configuration &configM;
 
@@ -244,6 +244,11 @@ public:
         return 0;
     }
 
+    virtual u32 GetAlignof() const
+    {
+        return 0;
+    }
+
     virtual bool HasStructureName() const
     {
         return hasStructureNameM;
@@ -280,6 +285,13 @@ public:
 
     virtual const Field &GetField(u32 index) const;
 
+    virtual const FieldLayout *GetFieldLayout() const
+    {
+        return 0;
+    }
+
+    virtual const Field *LookupDeclaredField(const char *pName) const;
+
     virtual bool IsAnonymous() const
     {
         return isAnonymousM;
@@ -327,6 +339,67 @@ public:
     {
     }
 
+    virtual void *ConstructAt(void * /* pMemory */) const
+    {
+        return 0;
+    }
+
+    virtual void DestroyAt(void * /* pInstance */) const
+    {
+    }
+
+    virtual bool IsCopyConstructible() const
+    {
+        return false;
+    }
+
+    virtual bool IsCopyAssignable() const
+    {
+        return false;
+    }
+
+    virtual bool IsTriviallyCopyable() const
+    {
+        return false;
+    }
+
+    virtual bool IsTriviallyDestructible() const
+    {
+        return false;
+    }
+
+    virtual bool IsTriviallyDefaultConstructible() const
+    {
+        return false;
+    }
+
+    virtual bool IsStandardLayout() const
+    {
+        return false;
+    }
+
+    virtual void *CopyConstruct(void * /* pMemory */, 
+                                const void * /* pOther */) const
+    {
+        return 0;
+    }
+
+    virtual void *MoveConstruct(void * /* pMemory */, 
+                                void * /* pOther */) const
+    {
+        return 0;
+    }
+
+    virtual void CopyAssign(void * /* pInstance */, 
+                            const void * /* pOther */) const
+    {
+    }
+
+    virtual void MoveAssign(void * /* pInstance */, 
+                            void * /* pOther */) const
+    {
+    }
+
 private:
 
     ParsedContext superM;
@@ -390,6 +463,16 @@ public:
         return 0;
     }
 
+    virtual bool HasOffset() const
+    {
+        return false;
+    }
+
+    virtual u32 GetOffset() const
+    {
+        return 0;
+    }
+
 private:
 
     Structure *pStructureM;
@@ -454,6 +537,11 @@ public:
         return superM.GetSizeof();
     }
 
+    virtual u32 GetAlignof() const
+    {
+        return superM.GetAlignof();
+    }
+
     virtual bool HasStructureName() const
     {
         return superM.HasStructureName();
@@ -499,6 +587,16 @@ public:
         return superM.GetField(index);
     }
 
+    virtual const FieldLayout *GetFieldLayout() const
+    {
+        return superM.GetFieldLayout();
+    }
+
+    virtual const Field *LookupDeclaredField(const char *pName) const
+    {
+        return superM.LookupDeclaredField(pName);
+    }
+
     virtual bool IsAnonymous() const
     {
         return superM.IsAnonymous();
@@ -554,6 +652,66 @@ public:
         return superM.DeleteArray(pInstanceArray);
     }
 
+    virtual void *ConstructAt(void *pMemory) const
+    {
+        return superM.ConstructAt(pMemory);
+    }
+
+    virtual void DestroyAt(void *pInstance) const
+    {
+        return superM.DestroyAt(pInstance);
+    }
+
+    virtual bool IsCopyConstructible() const
+    {
+        return superM.IsCopyConstructible();
+    }
+
+    virtual bool IsCopyAssignable() const
+    {
+        return superM.IsCopyAssignable();
+    }
+
+    virtual bool IsTriviallyCopyable() const
+    {
+        return superM.IsTriviallyCopyable();
+    }
+
+    virtual bool IsTriviallyDestructible() const
+    {
+        return superM.IsTriviallyDestructible();
+    }
+
+    virtual bool IsTriviallyDefaultConstructible() const
+    {
+        return superM.IsTriviallyDefaultConstructible();
+    }
+
+    virtual bool IsStandardLayout() const
+    {
+        return superM.IsStandardLayout();
+    }
+
+    virtual void *CopyConstruct(void *pMemory, const void *pOther) const
+    {
+        return superM.CopyConstruct(pMemory, pOther);
+    }
+
+    virtual void *MoveConstruct(void *pMemory, void *pOther) const
+    {
+        return superM.MoveConstruct(pMemory, pOther);
+    }
+
+    virtual void CopyAssign(void *pInstance, const void *pOther) const
+    {
+        return superM.CopyAssign(pInstance, pOther);
+    }
+
+    virtual void MoveAssign(void *pInstance, void *pOther) const
+    {
+        return superM.MoveAssign(pInstance, pOther);
+    }
+
 private:
 
     ParsedStructure superM;
@@ -614,6 +772,11 @@ public:
         return superM.GetSizeof();
     }
 
+    virtual u32 GetAlignof() const
+    {
+        return superM.GetAlignof();
+    }
+
     virtual bool HasStructureName() const
     {
         return superM.HasStructureName();
@@ -659,6 +822,16 @@ public:
         return superM.GetField(index);
     }
 
+    virtual const FieldLayout *GetFieldLayout() const
+    {
+        return superM.GetFieldLayout();
+    }
+
+    virtual const Field *LookupDeclaredField(const char *pName) const
+    {
+        return superM.LookupDeclaredField(pName);
+    }
+
     virtual bool IsAnonymous() const
     {
         return superM.IsAnonymous();
@@ -714,6 +887,66 @@ public:
         return superM.DeleteArray(pInstanceArray);
     }
 
+    virtual void *ConstructAt(void *pMemory) const
+    {
+        return superM.ConstructAt(pMemory);
+    }
+
+    virtual void DestroyAt(void *pInstance) const
+    {
+        return superM.DestroyAt(pInstance);
+    }
+
+    virtual bool IsCopyConstructible() const
+    {
+        return superM.IsCopyConstructible();
+    }
+
+    virtual bool IsCopyAssignable() const
+    {
+        return superM.IsCopyAssignable();
+    }
+
+    virtual bool IsTriviallyCopyable() const
+    {
+        return superM.IsTriviallyCopyable();
+    }
+
+    virtual bool IsTriviallyDestructible() const
+    {
+        return superM.IsTriviallyDestructible();
+    }
+
+    virtual bool IsTriviallyDefaultConstructible() const
+    {
+        return superM.IsTriviallyDefaultConstructible();
+    }
+
+    virtual bool IsStandardLayout() const
+    {
+        return superM.IsStandardLayout();
+    }
+
+    virtual void *CopyConstruct(void *pMemory, const void *pOther) const
+    {
+        return superM.CopyConstruct(pMemory, pOther);
+    }
+
+    virtual void *MoveConstruct(void *pMemory, void *pOther) const
+    {
+        return superM.MoveConstruct(pMemory, pOther);
+    }
+
+    virtual void CopyAssign(void *pInstance, const void *pOther) const
+    {
+        return superM.CopyAssign(pInstance, pOther);
+    }
+
+    virtual void MoveAssign(void *pInstance, void *pOther) const
+    {
+        return superM.MoveAssign(pInstance, pOther);
+    }
+
     // Struct methods ---------------------------------------------------------
 
     virtual bool IsAbstract() const
@@ -728,6 +961,12 @@ public:
 
     virtual const Method &GetMethod(u32 index) const;
 
+    virtual MethodOverloads LookupDeclaredMethods(const char *pName) const;
+
+    virtual const Method *LookupDeclaredMethod
+        (const char *pName, u32 argumentCount, 
+         const Xrtti::Type * const *pArgumentTypes) const;
+
 private:
 
     ParsedStructure superM;
@@ -735,6 +974,9 @@ private:
     bool isAbstractM;
 
     std::vector<ParsedMethod> vMethodsM;
+
+    // The same Methods, sorted by name, and then in declaration order
+    std::vector<const Method *> vMethodsByNameM;
 };
 
 
@@ -797,6 +1039,11 @@ public:
         return superM.GetSizeof();
     }
 
+    virtual u32 GetAlignof() const
+    {
+        return superM.GetAlignof();
+    }
+
     virtual bool HasStructureName() const
     {
         return superM.HasStructureName();
@@ -842,6 +1089,16 @@ public:
         return superM.GetField(index);
     }
 
+    virtual const FieldLayout *GetFieldLayout() const
+    {
+        return superM.GetFieldLayout();
+    }
+
+    virtual const Field *LookupDeclaredField(const char *pName) const
+    {
+        return superM.LookupDeclaredField(pName);
+    }
+
     virtual bool IsAnonymous() const
     {
         return superM.IsAnonymous();
@@ -897,6 +1154,66 @@ public:
         return superM.DeleteArray(pInstanceArray);
     }
 
+    virtual void *ConstructAt(void *pMemory) const
+    {
+        return superM.ConstructAt(pMemory);
+    }
+
+    virtual void DestroyAt(void *pInstance) const
+    {
+        return superM.DestroyAt(pInstance);
+    }
+
+    virtual bool IsCopyConstructible() const
+    {
+        return superM.IsCopyConstructible();
+    }
+
+    virtual bool IsCopyAssignable() const
+    {
+        return superM.IsCopyAssignable();
+    }
+
+    virtual bool IsTriviallyCopyable() const
+    {
+        return superM.IsTriviallyCopyable();
+    }
+
+    virtual bool IsTriviallyDestructible() const
+    {
+        return superM.IsTriviallyDestructible();
+    }
+
+    virtual bool IsTriviallyDefaultConstructible() const
+    {
+        return superM.IsTriviallyDefaultConstructible();
+    }
+
+    virtual bool IsStandardLayout() const
+    {
+        return superM.IsStandardLayout();
+    }
+
+    virtual void *CopyConstruct(void *pMemory, const void *pOther) const
+    {
+        return superM.CopyConstruct(pMemory, pOther);
+    }
+
+    virtual void *MoveConstruct(void *pMemory, void *pOther) const
+    {
+        return superM.MoveConstruct(pMemory, pOther);
+    }
+
+    virtual void CopyAssign(void *pInstance, const void *pOther) const
+    {
+        return superM.CopyAssign(pInstance, pOther);
+    }
+
+    virtual void MoveAssign(void *pInstance, void *pOther) const
+    {
+        return superM.MoveAssign(pInstance, pOther);
+    }
+
     // Struct methods ---------------------------------------------------------
 
     virtual bool IsAbstract() const
@@ -914,6 +1231,19 @@ public:
         return superM.GetMethod(index);
     }
 
+    virtual MethodOverloads LookupDeclaredMethods(const char *pName) const
+    {
+        return superM.LookupDeclaredMethods(pName);
+    }
+
+    virtual const Method *LookupDeclaredMethod
+        (const char *pName, u32 argumentCount, 
+         const Xrtti::Type * const *pArgumentTypes) const
+    {
+        return superM.LookupDeclaredMethod
+            (pName, argumentCount, pArgumentTypes);
+    }
+
 private:
 
     ParsedStruct superM;
@@ -1010,6 +1340,30 @@ public:
         return bitCountM;
     }
 
+    virtual u32 GetBitfieldStorageSize() const
+    {
+        return 0;
+    }
+
+    virtual u32 GetBitfieldOffset() const
+    {
+        return 0;
+    }
+
+    virtual u32 GetBitfieldShift() const
+    {
+        return 0;
+    }
+
+    virtual u64 GetBits(void * /* pInstance */) const
+    {
+        return 0;
+    }
+
+    virtual void SetBits(void * /* pInstance */, u64 /* value */) const
+    {
+    }
+
     virtual bool HasOffset() const
     {
         return false;
@@ -1030,6 +1384,11 @@ public:
         return 0;
     }
 
+    virtual GetThunk GetGetThunk() const
+    {
+        return 0;
+    }
+
 private:
 
     ParsedMember superM;
@@ -1350,6 +1709,17 @@ public:
         return 0;
     }
 
+    virtual InvokeThunk GetInvokeThunk() const
+    {
+        return 0;
+    }
+
+    virtual void *ConstructAt(void * /* pMemory */, 
+                              void ** /* pArgumentValues */) const
+    {
+        return 0;
+    }
+
 private:
 
     ParsedMember superM;
@@ -1440,6 +1810,33 @@ public:
     {
     }
 
+    virtual InvokeThunk GetInvokeThunk() const
+    {
+        return 0;
+    }
+
+    virtual bool IsBatchInvokeable() const
+    {
+        return false;
+    }
+
+    virtual bool InvokeBatch(void * /* pInstances */, u32 /* count */, 
+                             u32 /* stride */, void * /* pReturnValues */, 
+                             void ** /* pArgumentValues */) const
+    {
+        return false;
+    }
+
+    virtual DirectInvoke GetDirectInvoke() const
+    {
+        return 0;
+    }
+
+    virtual const std::type_info *GetDirectInvokeType() const
+    {
+        return 0;
+    }
+
 private:
 
     ParsedMember superM;
@@ -1506,6 +1903,26 @@ public:
         return *(vArrayOrPointersM[index]);
     }
 
+    virtual bool HasSizeof() const
+    {
+        return false;
+    }
+
+    virtual u32 GetSizeof() const
+    {
+        return 0;
+    }
+
+    virtual u32 GetAlignof() const
+    {
+        return 0;
+    }
+
+    virtual const Type &GetCanonical() const
+    {
+        return *this;
+    }
+
 private:
 
     BaseType baseTypeM;
@@ -1529,6 +1946,13 @@ public:
     {
     }
 
+    // ArrayOrPointer methods -------------------------------------------------
+
+    virtual u32 GetElementStride() const
+    {
+        return 0;
+    }
+
     // Array methods ----------------------------------------------------------
 
     virtual bool IsUnbounded() const
@@ -1588,6 +2012,13 @@ public:
     {
     }
 
+    // ArrayOrPointer methods -------------------------------------------------
+
+    virtual u32 GetElementStride() const
+    {
+        return 0;
+    }
+
     // Pointer methods --------------------------------------------------------
 
     virtual bool IsConst() const
@@ -1648,8 +2079,30 @@ public:
         return valuesM[index];
     }
 
+    virtual const char *LookupName(s32 value) const;
+
+    virtual bool LookupValue(const char *pName, s32 *pValue) const;
+
+    virtual u32 GetFlagCount() const
+    {
+        return flagsM.size();
+    }
+
+    virtual const EnumerationValue &GetFlag(u32 index) const
+    {
+        return valuesM[flagsM[index]];
+    }
+
+    virtual bool IsFlags() const
+    {
+        return isFlagsM;
+    }
+
 private:
 
+    // Finds the flags of valuesM
+    void FindFlags();
+
     AccessType accessTypeM;
 
     Context *pContextM;
@@ -1657,6 +2110,11 @@ private:
     std::string nameM;
 
     std::vector<ParsedEnumerationValue> valuesM;
+
+    // The indexes in valuesM of the flags, in order of their bit
+    std::vector<u32> flagsM;
+
+    bool isFlagsM;
 };
 
 
@@ -1702,6 +2160,27 @@ public:
         return superM.GetArrayOrPointer(index);
     }
 
+    virtual bool HasSizeof() const
+    {
+        return superM.HasSizeof();
+    }
+
+    virtual u32 GetSizeof() const
+    {
+        return superM.GetSizeof();
+    }
+
+    virtual u32 GetAlignof() const
+    {
+        return superM.GetAlignof();
+    }
+
+    // Parsed Types are not interned
+    virtual const Type &GetCanonical() const
+    {
+        return *this;
+    }
+
     // TypeEnumeration methods ------------------------------------------------
 
     virtual const Enumeration &GetEnumeration() const
@@ -1761,6 +2240,27 @@ public:
         return superM.GetArrayOrPointer(index);
     }
 
+    virtual bool HasSizeof() const
+    {
+        return superM.HasSizeof();
+    }
+
+    virtual u32 GetSizeof() const
+    {
+        return superM.GetSizeof();
+    }
+
+    virtual u32 GetAlignof() const
+    {
+        return superM.GetAlignof();
+    }
+
+    // Parsed Types are not interned
+    virtual const Type &GetCanonical() const
+    {
+        return *this;
+    }
+
     // TypeFunction methods ---------------------------------------------------
 
     virtual const MethodSignature &GetSignature() const
@@ -1822,6 +2322,27 @@ public:
         return superM.GetArrayOrPointer(index);
     }
 
+    virtual bool HasSizeof() const
+    {
+        return superM.HasSizeof();
+    }
+
+    virtual u32 GetSizeof() const
+    {
+        return superM.GetSizeof();
+    }
+
+    virtual u32 GetAlignof() const
+    {
+        return superM.GetAlignof();
+    }
+
+    // Parsed Types are not interned
+    virtual const Type &GetCanonical() const
+    {
+        return *this;
+    }
+
     // TypeStructure methods --------------------------------------------------
 
     virtual const Structure &GetStructure() const
@@ -37,8 +37,58 @@ typedef uint32_t              u32;      /**< 32-bit unsigned */
 
 class XrttiAccess;
 
+// Base classes of TestMethods, whose members are looked up through it
+class TestMethodsFirst
+{
+public:
+
+    TestMethodsFirst()
+        : firstM(1), sharedM(1)
+    {
+    }
+
+    u32 Shared() const
+    {
+        return sharedM;
+    }
+
+    u32 firstM;
+
+    // Also in TestMethodsSecond, so ambiguous in TestMethods
+    u32 sharedM;
+};
+
+class TestMethodsSecond
+{
+public:
+
+    TestMethodsSecond()
+        : secondM(2), sharedM(2)
+    {
+    }
+
+    u32 Shared() const
+    {
+        return sharedM;
+    }
+
+    u32 Second() const
+    {
+        return secondM;
+    }
+
+    u32 Second(u32 add) const
+    {
+        return secondM + add;
+    }
+
+    u32 secondM;
+
+    u32 sharedM;
+};
+
 // Defines a bunch of methods that we can test invocation with
-class TestMethods
+class TestMethods : public TestMethodsFirst, public TestMethodsSecond
 {
 public:
 
@@ -115,6 +165,74 @@ private:
     Inner innerM;
 
     Inner *pInnerM;
+
+    Inner innersM[3];
+
+    unsigned short gridM[4][8];
+};
+
+// A header of bitfields, like those of a network protocol, whose bits are
+// read and written through its Fields
+struct TestMethodsBits
+{
+    u32 version : 4;
+    u32 length : 4;
+    s32 offset : 13;
+    u32 flags : 3;
+    u32 ttl : 8;
+};
+
+// An abstract class, whose size and alignment, and those of the Type of a
+// reference to it, are generated without instantiating it
+class TestMethodsAbstract
+{
+public:
+
+    virtual ~TestMethodsAbstract()
+    {
+    }
+
+    virtual u32 Size() const = 0;
+
+    bool SameSize(const TestMethodsAbstract &other) const
+    {
+        return (this->Size() == other.Size());
+    }
+};
+
+// Enums whose names and values are looked up through their Enumerations:
+// one with values close enough together to be looked up by index, with a
+// missing value and a second name for a value; one with values too far
+// apart for that; and one of bit flags
+enum TestMethodsColor
+{
+    Color_Red = 3,
+    Color_Green = 4,
+    Color_Blue = 6,
+    Color_Crimson = 3
+};
+
+enum TestMethodsSparse
+{
+    Sparse_Low = -100000,
+    Sparse_Zero = 0,
+    Sparse_High = 100000
+};
+
+enum TestMethodsAccess
+{
+    Access_None = 0,
+    Access_Read = 1,
+    Access_Write = 2,
+    Access_ReadWrite = 3,
+    Access_Execute = 8
+};
+
+struct TestMethodsEnums
+{
+    TestMethodsColor color;
+    TestMethodsSparse sparse;
+    TestMethodsAccess access;
 };
 
 #endif // TEST_METHODS_H
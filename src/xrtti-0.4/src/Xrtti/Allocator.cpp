@@ -0,0 +1,228 @@
+/*****************************************************************************\
+ *                                                                           *
+ * Allocator.cpp                                                             *
+ *                                                                           *
+ * ------------------------------------------------------------------------- *
+ * Copyright (C) 2007 Bryan Ischo <bryan@ischo.com>                          *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU General Public License Version 2 as published  *
+ * by the Free Software Foundation.                                          *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General *
+ * Public License for more details.                                          *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program; if not, write to:                                *
+ * The Free Software Foundation, Inc.                                        *
+ * 51 Franklin Street, Fifth Floor                                           *
+ * Boston, MA 02110-1301, USA.                                               *
+ * ------------------------------------------------------------------------- *
+ *                                                                           *
+\*****************************************************************************/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "Xrtti/Xrtti.h"
+
+namespace Xrtti {
+
+#if 0 // This fixes indentation in emacs
+}
+#endif
+
+
+// Each chunk of an ArenaAllocator, or slab of a PoolAllocator, begins with
+// this header; its memory follows
+typedef struct Chunk
+{
+    struct Chunk *pNext;
+    size_t size;
+} Chunk;
+
+
+static inline char *align_up(char *p, u32 alignment)
+{
+    return (char *) ((((uintptr_t) p) + (alignment - 1)) & 
+                     ~((uintptr_t) (alignment - 1)));
+}
+
+
+static Chunk *chunk_allocate(Chunk *pNext, size_t size)
+{
+    Chunk *pChunk = (Chunk *) malloc(sizeof(Chunk) + size);
+
+    if (pChunk) {
+        pChunk->pNext = pNext;
+        pChunk->size = size;
+    }
+
+    return pChunk;
+}
+
+
+static void chunk_free_all(Chunk *pChunk)
+{
+    while (pChunk) {
+        Chunk *pNext = pChunk->pNext;
+        free(pChunk);
+        pChunk = pNext;
+    }
+}
+
+
+ArenaAllocator::ArenaAllocator(u32 chunkSize)
+    : chunkSizeM(chunkSize), pChunksM(0), pNextM(0), pEndM(0)
+{
+}
+
+
+ArenaAllocator::~ArenaAllocator()
+{
+    chunk_free_all((Chunk *) pChunksM);
+}
+
+
+void *ArenaAllocator::Allocate(u32 size, u32 alignment)
+{
+    if (pNextM) {
+        char *pRet = align_up(pNextM, alignment);
+        if ((pRet <= pEndM) && (size <= (size_t) (pEndM - pRet))) {
+            pNextM = pRet + size;
+            return pRet;
+        }
+    }
+
+    // Worst case, the memory of a new chunk must be advanced by
+    // (alignment - 1) bytes to align it
+    size_t needed = ((size_t) size) + (alignment - 1);
+
+    // Allocations too large for a chunk get one of their own, which is
+    // linked in behind the current chunk so that allocation continues from
+    // the current chunk
+    if (needed > chunkSizeM) {
+        Chunk *pHead = (Chunk *) pChunksM;
+        Chunk *pChunk = chunk_allocate(pHead ? pHead->pNext : 0, needed);
+        if (!pChunk) {
+            return 0;
+        }
+        if (pHead) {
+            pHead->pNext = pChunk;
+        }
+        else {
+            pChunksM = pChunk;
+        }
+        return align_up((char *) (pChunk + 1), alignment);
+    }
+
+    Chunk *pChunk = chunk_allocate((Chunk *) pChunksM, chunkSizeM);
+    if (!pChunk) {
+        return 0;
+    }
+    pChunksM = pChunk;
+
+    char *pRet = align_up((char *) (pChunk + 1), alignment);
+    pNextM = pRet + size;
+    pEndM = ((char *) (pChunk + 1)) + chunkSizeM;
+
+    return pRet;
+}
+
+
+void ArenaAllocator::Free(void * /* pMemory */, u32 /* size */)
+{
+}
+
+
+void ArenaAllocator::Reset()
+{
+    // Keep the first full-sized chunk, free the rest
+    Chunk *pKept = 0, *pChunk = (Chunk *) pChunksM;
+
+    while (pChunk) {
+        Chunk *pNext = pChunk->pNext;
+        if (!pKept && (pChunk->size == chunkSizeM)) {
+            pKept = pChunk;
+            pKept->pNext = 0;
+        }
+        else {
+            free(pChunk);
+        }
+        pChunk = pNext;
+    }
+
+    pChunksM = pKept;
+    if (pKept) {
+        pNextM = (char *) (pKept + 1);
+        pEndM = pNextM + chunkSizeM;
+    }
+    else {
+        pNextM = pEndM = 0;
+    }
+}
+
+
+PoolAllocator::PoolAllocator(const Structure &structure, u32 slabCount)
+    : sizeM(structure.GetSizeof()), slabCountM(slabCount ? slabCount : 1),
+      pSlabsM(0), pFreeM(0)
+{
+    // Each free block holds the free list link, so must be at least as
+    // large and aligned as a pointer
+    alignmentM = structure.GetAlignof();
+    if (alignmentM < sizeof(void *)) {
+        alignmentM = sizeof(void *);
+    }
+    blockSizeM = (sizeM < sizeof(void *)) ? sizeof(void *) : sizeM;
+    blockSizeM = (blockSizeM + (alignmentM - 1)) & ~(alignmentM - 1);
+}
+
+
+PoolAllocator::~PoolAllocator()
+{
+    chunk_free_all((Chunk *) pSlabsM);
+}
+
+
+void *PoolAllocator::Allocate(u32 size, u32 alignment)
+{
+    if ((size > sizeM) || (alignment > alignmentM)) {
+        return 0;
+    }
+
+    if (!pFreeM) {
+        Chunk *pSlab = chunk_allocate
+            ((Chunk *) pSlabsM, (((size_t) slabCountM) * blockSizeM) + 
+             (alignmentM - 1));
+        if (!pSlab) {
+            return 0;
+        }
+        pSlabsM = pSlab;
+
+        // Push the blocks last first, so that they are allocated in order
+        char *pBlocks = align_up((char *) (pSlab + 1), alignmentM);
+        for (u32 i = slabCountM; i--; ) {
+            void *pBlock = pBlocks + (((size_t) i) * blockSizeM);
+            * (void **) pBlock = pFreeM;
+            pFreeM = pBlock;
+        }
+    }
+
+    void *pRet = pFreeM;
+    pFreeM = * (void **) pRet;
+
+    return pRet;
+}
+
+
+void PoolAllocator::Free(void *pMemory, u32 /* size */)
+{
+    if (pMemory) {
+        * (void **) pMemory = pFreeM;
+        pFreeM = pMemory;
+    }
+}
+
+
+}; // namespace Xrtti
@@ -37,6 +37,10 @@ bool Base::operator ==(const Base &other) const
         return false;
     }
 
+    // The offset is not compared: Parsed Bases never have one, and it
+    // follows from the layout of the Structures anyway.  Nor is it part of
+    // the fingerprint which detects duplicate registrations, which must
+    // agree with this.
     return (this->IsCastable() == other.IsCastable());
 }
 
@@ -29,6 +29,9 @@
  *                                                                           *
 \*****************************************************************************/
 
+#include <alloca.h>
+#include <sched.h>
+#include <string.h>
 #include <Xrtti/XrttiPrivate.h>
 
 
@@ -39,6 +42,140 @@ namespace Xrtti {
 #endif
 
 
+// Returns the index of the first of the [count] Members in pMembers, which
+// are sorted by name, whose name is not less than pName
+template <typename T>
+static u32 lower_bound_by_name(u32 count, T **pMembers, const char *pName)
+{
+    u32 low = 0, high = count;
+
+    while (low < high) {
+        u32 middle = low + ((high - low) / 2);
+        if (strcmp(pMembers[middle]->GetName(), pName) < 0) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+
+// The states of a once-guard, which is initially Once_Pending
+enum
+{
+    Once_Pending,
+    Once_Running,
+    Once_Done
+};
+
+
+// Returns true if the caller is to do the work guarded by *pState and then
+// call once_end(); otherwise returns false once that work has been done
+static bool once_begin(u32 *pState)
+{
+    u32 state = __atomic_load_n(pState, __ATOMIC_ACQUIRE);
+
+    while (state != Once_Done) {
+        if (state == Once_Running) {
+            sched_yield();
+            state = __atomic_load_n(pState, __ATOMIC_ACQUIRE);
+        }
+        else if (__atomic_compare_exchange_n
+                 (pState, &state, (u32) Once_Running, false, 
+                  __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+static void once_end(u32 *pState)
+{
+    __atomic_store_n(pState, (u32) Once_Done, __ATOMIC_RELEASE);
+}
+
+
+// Continues an FNV-1a hash over the four bytes of value
+static u32 hash_u32(u32 hash, u32 value)
+{
+    for (u32 i = 0; i < 4; i++) {
+        hash = (hash ^ ((value >> (8 * i)) & 0xFF)) * 16777619UL;
+    }
+
+    return hash;
+}
+
+
+// Only hashes what Equals() compares cheaply, so that Types which are
+// Equals() always hash equally
+static u32 hash_type(u32 hash, const Type &type)
+{
+    hash = hash_u32(hash, type.GetBaseType());
+    hash = hash_u32(hash, (type.IsConst() ? 1 : 0) | 
+                    (type.IsVolatile() ? 2 : 0) |
+                    (type.IsReference() ? 4 : 0));
+
+    u32 count = type.GetArrayOrPointerCount();
+    hash = hash_u32(hash, count);
+    for (u32 i = 0; i < count; i++) {
+        const ArrayOrPointer &arrayOrPointer = type.GetArrayOrPointer(i);
+        if (arrayOrPointer.GetType() == ArrayOrPointer::Type_Array) {
+            const Array &array = (const Array &) arrayOrPointer;
+            hash = hash_u32(hash, array.IsUnbounded() ? 0xFFFFFFFFUL :
+                            array.GetElementCount());
+        }
+        else {
+            const Pointer &pointer = (const Pointer &) arrayOrPointer;
+            hash = hash_u32(hash, (pointer.IsConst() ? 1 : 0) |
+                            (pointer.IsVolatile() ? 2 : 0));
+        }
+    }
+
+    switch (type.GetBaseType()) {
+    case Type::BaseType_Enumeration:
+        return hash_u32(hash, CompiledContextSet::Hash
+                        (((const TypeEnumeration &) type).
+                         GetEnumeration().GetName()));
+    case Type::BaseType_Function:
+        return hash_u32(hash, ((const TypeFunction &) type).GetSignature().
+                        GetArgumentCount());
+    case Type::BaseType_Structure:
+        return hash_u32(hash, CompiledContextSet::Hash
+                        (((const TypeStructure &) type).
+                         GetStructure().GetFullName()));
+    default:
+        return hash;
+    }
+}
+
+
+static bool method_matches(const Method &method, const char *pName, 
+                           u32 argumentCount, 
+                           const Xrtti::Type * const *pArgumentTypes)
+{
+    const MethodSignature &signature = method.GetSignature();
+
+    if ((signature.GetArgumentCount() != argumentCount) ||
+        strcmp(method.GetName(), pName)) {
+        return false;
+    }
+
+    for (u32 i = 0; i < argumentCount; i++) {
+        if (!Equals(signature.GetArgument(i).GetType(), 
+                    *(pArgumentTypes[i]))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
 const Base &CompiledStructure::GetBase(u32 index) const
 {
     return *(pBasesM[index]);
@@ -57,6 +194,48 @@ const Field &CompiledStructure::GetField(u32 index) const
 }
 
 
+void CompiledStructure::LayoutBitfields() const
+{
+    for (u32 i = 0; i < fieldCountM; i++) {
+        FieldLayout &layout = pFieldLayoutM[i];
+        if (!(layout.flags & FieldLayout::Flag_Bitfield)) {
+            continue;
+        }
+        const Field &field = *(pFieldsM[i]);
+        if (field.GetBitfieldStorageSize()) {
+            layout.offset = field.GetBitfieldOffset();
+            layout.size = field.GetBitfieldStorageSize();
+            layout.bitShift = (u8) field.GetBitfieldShift();
+            layout.flags |= FieldLayout::Flag_HasOffset;
+        }
+    }
+}
+
+
+const FieldLayout *CompiledStructure::GetFieldLayout() const
+{
+    if (pFieldLayoutM && once_begin(&fieldLayoutStateM)) {
+        this->LayoutBitfields();
+        once_end(&fieldLayoutStateM);
+    }
+
+    return pFieldLayoutM;
+}
+
+
+const Field *CompiledStructure::LookupDeclaredField(const char *pName) const
+{
+    u32 index = lower_bound_by_name(fieldCountM, pFieldsByNameM, pName);
+
+    if ((index < fieldCountM) && 
+        !strcmp(pFieldsByNameM[index]->GetName(), pName)) {
+        return pFieldsByNameM[index];
+    }
+
+    return 0;
+}
+
+
 const Constructor &CompiledStructure::GetConstructor(u32 index) const
 {
     return *(pConstructorsM[index]);
@@ -69,18 +248,240 @@ const Destructor &CompiledStructure::GetDestructor() const
 }
 
 
+// Trivially copyable instances are copied, whether the copy is a move or
+// not, by copying their bytes rather than through the generated code
+void *CompiledStructure::CopyConstruct(void *pMemory, const void *pOther) const
+{
+    if (traitsM & CompiledTrait_TriviallyCopyable) {
+        return memcpy(pMemory, pOther, sizeofM);
+    }
+
+    return (*pCopyConstructM)(pMemory, pOther);
+}
+
+
+void *CompiledStructure::MoveConstruct(void *pMemory, void *pOther) const
+{
+    if (traitsM & CompiledTrait_TriviallyCopyable) {
+        return memcpy(pMemory, pOther, sizeofM);
+    }
+
+    return (*pMoveConstructM)(pMemory, pOther);
+}
+
+
+void CompiledStructure::CopyAssign(void *pInstance, const void *pOther) const
+{
+    if (traitsM & CompiledTrait_TriviallyCopyable) {
+        memmove(pInstance, pOther, sizeofM);
+    }
+    else {
+        (*pCopyAssignM)(pInstance, pOther);
+    }
+}
+
+
+void CompiledStructure::MoveAssign(void *pInstance, void *pOther) const
+{
+    if (traitsM & CompiledTrait_TriviallyCopyable) {
+        memmove(pInstance, pOther, sizeofM);
+    }
+    else {
+        (*pMoveAssignM)(pInstance, pOther);
+    }
+}
+
+
 const Method &CompiledStruct::GetMethod(u32 index) const
 {
     return *(pMethodsM[index]);
 }
 
 
+MethodOverloads CompiledStruct::LookupDeclaredMethods(const char *pName) const
+{
+    u32 first = lower_bound_by_name(methodCountM, pMethodsByNameM, pName);
+
+    // Overloads are adjacent, since they all have the same name
+    u32 last = first;
+    while ((last < methodCountM) &&
+           !strcmp(pMethodsByNameM[last]->GetName(), pName)) {
+        last++;
+    }
+
+    if (last == first) {
+        return MethodOverloads();
+    }
+
+    return MethodOverloads(last - first, &(pMethodsByNameM[first]));
+}
+
+
+const Method *CompiledStruct::LookupDeclaredMethod
+    (const char *pName, u32 argumentCount, 
+     const Xrtti::Type * const *pArgumentTypes) const
+{
+    if (!overloadCapacityM) {
+        return 0;
+    }
+
+    u32 hash = HashOverload(pName, argumentCount, pArgumentTypes);
+    u32 mask = overloadCapacityM - 1;
+
+    // The table is never more than half full, so there is always an empty
+    // slot to stop at
+    for (u32 i = hash & mask; pOverloadsM[i].pMethod; i = (i + 1) & mask) {
+        if ((pOverloadsM[i].hash == hash) &&
+            method_matches(*(pOverloadsM[i].pMethod), pName, argumentCount,
+                           pArgumentTypes)) {
+            return pOverloadsM[i].pMethod;
+        }
+    }
+
+    return 0;
+}
+
+
+/* static */
+u32 CompiledStruct::HashOverload(const char *pName, u32 argumentCount,
+                                 const Xrtti::Type * const *pArgumentTypes)
+{
+    u32 hash = hash_u32(CompiledContextSet::Hash(pName), argumentCount);
+
+    for (u32 i = 0; i < argumentCount; i++) {
+        hash = hash_type(hash, *(pArgumentTypes[i]));
+    }
+
+    return hash;
+}
+
+
 const Type &CompiledField::GetType() const
 {
     return *pTypeM;
 }
 
 
+// Reads the [size] byte storage unit of a bitfield as a native-endian
+// unsigned integer; memcpy of a constant size compiles to a single load
+static u64 load_bits(const unsigned char *pStorage, u32 size)
+{
+    switch (size) {
+    case 1:
+        return *pStorage;
+    case 2: {
+        uint16_t value;
+        memcpy(&value, pStorage, sizeof(value));
+        return value;
+    }
+    case 4: {
+        uint32_t value;
+        memcpy(&value, pStorage, sizeof(value));
+        return value;
+    }
+    default: {
+        u64 value;
+        memcpy(&value, pStorage, sizeof(value));
+        return value;
+    }
+    }
+}
+
+
+static void store_bits(unsigned char *pStorage, u32 size, u64 bits)
+{
+    switch (size) {
+    case 1:
+        *pStorage = (unsigned char) bits;
+        break;
+    case 2: {
+        uint16_t value = (uint16_t) bits;
+        memcpy(pStorage, &value, sizeof(value));
+        break;
+    }
+    case 4: {
+        uint32_t value = (uint32_t) bits;
+        memcpy(pStorage, &value, sizeof(value));
+        break;
+    }
+    default:
+        memcpy(pStorage, &bits, sizeof(bits));
+        break;
+    }
+}
+
+
+void CompiledField::ProbeBits() const
+{
+    if (!pClearBitsM || !once_begin(&bitsStateM)) {
+        return;
+    }
+
+    // alloca() memory is aligned for any type, as the containing Structure
+    // must be
+    u32 containerSize = containerSizeM;
+    unsigned char *pBytes = (unsigned char *) alloca(containerSize);
+    memset(pBytes, 0xFF, containerSize);
+    (*pClearBitsM)(pBytes);
+
+    u32 first = containerSize, last = 0;
+    for (u32 i = 0; i < containerSize; i++) {
+        if (pBytes[i] != 0xFF) {
+            if (first == containerSize) {
+                first = i;
+            }
+            last = i;
+        }
+    }
+
+    // The storage unit is the smallest naturally aligned unit which holds
+    // every cleared byte; a bitfield which straddles such units (as in a
+    // packed Structure) is left without a layout
+    for (u32 size = 1; (first < containerSize) && (size <= 8); size *= 2) {
+        u32 offset = first & ~(size - 1);
+        if (((offset + size) <= last) || ((offset + size) > containerSize)) {
+            continue;
+        }
+        u64 all = (size == 8) ? ~((u64) 0) : ((((u64) 1) << (size * 8)) - 1);
+        u64 mask = ~load_bits(&(pBytes[offset]), size) & all;
+        u32 shift = 0;
+        while (!(mask & (((u64) 1) << shift))) {
+            shift++;
+        }
+        u64 expected = (bitCountM == 64) ? ~((u64) 0) : 
+            ((((u64) 1) << bitCountM) - 1);
+        if ((shift + bitCountM) <= 64 && (mask == (expected << shift))) {
+            bitStorageSizeM = size;
+            bitOffsetM = offset;
+            bitShiftM = shift;
+            bitMaskM = mask;
+        }
+        break;
+    }
+
+    once_end(&bitsStateM);
+}
+
+
+u64 CompiledField::GetBits(void *pInstance) const
+{
+    this->ProbeBits();
+    return ((load_bits(&(((unsigned char *) pInstance)[bitOffsetM]), 
+                       bitStorageSizeM) & bitMaskM) >> bitShiftM);
+}
+
+
+void CompiledField::SetBits(void *pInstance, u64 value) const
+{
+    this->ProbeBits();
+    unsigned char *pStorage = &(((unsigned char *) pInstance)[bitOffsetM]);
+
+    store_bits(pStorage, bitStorageSizeM, 
+               ((load_bits(pStorage, bitStorageSizeM) & ~bitMaskM) |
+                ((value << bitShiftM) & bitMaskM)));
+}
+
+
 const Type &CompiledArgument::GetType() const
 {
     return *pTypeM;
@@ -104,11 +505,76 @@ const EnumerationValue &CompiledEnumeration::GetValue(u32 index) const
 }
 
 
-CompiledRegister::CompiledRegister(u32 contextCount, Context **pContexts)
+const char *CompiledEnumeration::LookupName(s32 value) const
+{
+    if (isDenseM) {
+        u32 index = (u32) value - (u32) firstValueM;
+        if ((index < byValueCountM) && pValuesByValueM[index]) {
+            return pValuesByValueM[index]->GetName();
+        }
+        return 0;
+    }
+
+    u32 low = 0, high = byValueCountM;
+
+    while (low < high) {
+        u32 middle = low + ((high - low) / 2);
+        s32 middleValue = pValuesByValueM[middle]->GetValue();
+        if (middleValue < value) {
+            low = middle + 1;
+        }
+        else if (middleValue > value) {
+            high = middle;
+        }
+        else {
+            return pValuesByValueM[middle]->GetName();
+        }
+    }
+
+    return 0;
+}
+
+
+bool CompiledEnumeration::LookupValue(const char *pName, s32 *pValue) const
 {
-    for (u32 i = 0; i < contextCount; i++) {
-        CompiledContextSet::RegisterContext(pContexts[i]);
+    u32 index = lower_bound_by_name(valueCountM, pValuesByNameM, pName);
+
+    if ((index < valueCountM) && 
+        !strcmp(pValuesByNameM[index]->GetName(), pName)) {
+        *pValue = pValuesByNameM[index]->GetValue();
+        return true;
     }
+
+    return false;
+}
+
+
+const EnumerationValue &CompiledEnumeration::GetFlag(u32 index) const
+{
+    return *(pFlagsM[index]);
+}
+
+
+CompiledRegister::CompiledRegister(u32 contextCount, Context **pContexts,
+                                   const u32 *pHashes, 
+                                   const u32 *pFingerprints,
+                                   u32 typeCount, Type **pTypes,
+                                   const u32 *pTypeFingerprints)
+    : contextCountM(contextCount), pContextsM(pContexts), pHashesM(pHashes),
+      typeCountM(typeCount), pTypesM(pTypes), 
+      pTypeFingerprintsM(pTypeFingerprints)
+{
+    CompiledContextSet::RegisterContexts(contextCount, pContexts, pHashes,
+                                         pFingerprints);
+
+    CompiledContextSet::RegisterTypes(typeCount, pTypes, pTypeFingerprints);
+}
+
+
+CompiledRegister::~CompiledRegister()
+{
+    CompiledContextSet::Unregister(contextCountM, pContextsM, pHashesM,
+                                   typeCountM, pTypesM, pTypeFingerprintsM);
 }
 
 
@@ -29,9 +29,17 @@
  *                                                                           *
 \*****************************************************************************/
 
+#include <algorithm>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <link.h>
 #include <map>
+#include <pthread.h>
+#include <sched.h>
+#include <set>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <string>
 #include <vector>
 #include <Xrtti/XrttiPrivate.h>
@@ -46,36 +54,2023 @@ namespace Xrtti {
 #endif
 
 
-static map<string, Context *> htNonAnonymousContextsByNameG;
-static map<string, Structure *> htStructuresByTypeinfoG;
-static vector<Context *> vContextsG;
+// **************************************************************************
+// Registry data
+// **************************************************************************
 
+// The registry is read without any locking, and readers never wait for
+// writers.  Registration and unregistration are serialized by
+// registryMutexG, and only ever change the registry in ways that a
+// concurrent reader can tolerate:
+//
+// - A new entry is completely written before the pointer which makes it
+//   visible is published with a release store, and readers load that
+//   pointer with an acquire load.
+// - A removed index entry is replaced by a tombstone, which readers skip.
+// - A table which must grow or shrink is copied, and the copy is published
+//   in place of the old one.  The old table is retired, and is only freed
+//   after a grace period.
+//
+// Every reader runs inside of a read section (see ReadSection below).  A
+// grace period ends once every read section which was running when it
+// began has finished; after that no reader can still hold a pointer to
+// anything which was removed or retired before it began.  Unregistration
+// waits for a grace period before returning, so that once a CompiledRegister
+// has been destroyed, its library may be unmapped.
+//
+// Until the registry is first read, registration only pushes each batch of
+// Contexts onto pPendingG, so that a process which does few lookups does
+// not pay at startup for indexing everything that it registers.  The first
+// reader claims the pending batches by swapping pPendingG for indexingG,
+// and indexes them all at once, within its read section and without taking
+// registryMutexG; it is the only writer of the indexes until it sets
+// indexedG.  Any writer which finds the batches claimed waits for that, and
+// from then on registration indexes each Context as it is registered.
+// Retired tables are not freed by registration, which may be running in a
+// static constructor while the dynamic linker holds its lock, but by the
+// next writer which waits for a grace period.
+//
+// The class hierarchy index is otherwise the only thing which readers
+// build: the first reader which needs it after the registry has changed
+// builds it privately, within its read section, and then publishes it.  Every change
+// to the registry increments generationG once it is complete, and a
+// Hierarchy or CastPath built in an earlier generation is never used.
+//
+// All of the registry data are plain old data with no constructors, so that
+// they are zero-initialized before any CompiledRegister static initializer
+// runs, regardless of static initialization order.
+
+// One slot of an index; the slot is empty if pKey is NULL, and is a
+// tombstone if pKey is tombstoneG.  The hash is kept in the slot so that a
+// probe only compares key strings when the hash matches, which means that
+// a lookup does one hash computation and almost always at most one string
+// compare.
+typedef struct IndexSlot
+{
+    u32 hash;
+    const char *pKey;
+    Context *pContext;
+    // The structural fingerprint of pContext, if it has one; this is only
+    // used by registration, and so is never read by lookups
+    const u32 *pFingerprint;
+} IndexSlot;
+
+// An index of Contexts by a string key, using linear probing in a power of
+// two sized table in which at most half of the slots are in use
+typedef struct Index
+{
+    u32 capacity;
+    // Slots which are in use, including tombstones
+    u32 count;
+    // Slots which are in use, not including tombstones
+    u32 liveCount;
+    IndexSlot *pSlots;
+    // Indexes which have been replaced by a copy
+    struct Index *pRetired;
+} Index;
+
+// The list of all registered Contexts
+typedef struct ContextList
+{
+    u32 capacity;
+    u32 count;
+    Context **pContexts;
+    // Lists which have been replaced by a copy
+    struct ContextList *pRetired;
+} ContextList;
+
+// A Context which was registered with the same full name as one which was
+// already registered, and so which was not indexed; it is indexed in place
+// of the other one if the other one is unregistered
+typedef struct Duplicate
+{
+    Context *pContext;
+    u32 hash;
+    const u32 *pFingerprint;
+    struct Duplicate *pNext;
+    // Duplicates which have been removed from the list
+    struct Duplicate *pRetired;
+} Duplicate;
+
+// A Context which has been registered but not yet indexed
+typedef struct PendingContext
+{
+    Context *pContext;
+    u32 hash;
+    const u32 *pFingerprint;
+} PendingContext;
+
+// Contexts which were registered together before the registry was first
+// read, which are indexed by the first reader
+typedef struct PendingBatch
+{
+    u32 contextCount;
+    PendingContext *pContexts;
+    // The batch registered before this one
+    struct PendingBatch *pNext;
+    // Batches which have been removed from pPendingG
+    struct PendingBatch *pRetired;
+} PendingBatch;
+
+// The structural fingerprint of a Type, copied out of the generated file
+// which registered it, by which the Type is interned
+typedef struct TypeFingerprint
+{
+    u32 words[4];
+
+    bool operator <(const TypeFingerprint &other) const
+    {
+        return (memcmp(words, other.words, sizeof(words)) < 0);
+    }
+} TypeFingerprint;
+
+// What the class hierarchy index knows about one registered Structure.
+// Every Structure which has a subclass is given a bit, and each Structure
+// has the set of the bits of all of its ancestors, so that testing for an
+// ancestor is a single bit test.  The set only has as many words as are
+// needed to hold the highest bit in it.
+typedef struct HierarchyEntry
+{
+    const Structure *pStructure;
+    // HIERARCHY_NO_BIT if the Structure has no subclasses
+    u32 bit;
+    u32 ancestorWordCount;
+    const u32 *pAncestors;
+    u32 derivedCount;
+    const Structure **pDerived;
+} HierarchyEntry;
+
+#define HIERARCHY_NO_BIT 0xFFFFFFFF
+
+// One slot of the hierarchy index's table of Structures by address; the
+// slot is empty if pStructure is NULL.  Every registered Structure has a
+// slot, including those which were not indexed because they duplicate
+// another, which share the entry of the one that was indexed.
+typedef struct HierarchySlot
+{
+    const Structure *pStructure;
+    u32 entry;
+} HierarchySlot;
+
+// The class hierarchy index, which is built from the registry when it is
+// first needed, and is thrown away whenever the registry changes
+typedef struct Hierarchy
+{
+    // The generationG that it was built from
+    u32 generation;
+    HierarchyEntry *pEntries;
+    // A power of two, at least twice the number of Structures
+    u32 capacity;
+    HierarchySlot *pSlots;
+    // The storage of every entry's pAncestors and pDerived
+    u32 *pWords;
+    const Structure **pDerived;
+    // Hierarchies which have been thrown away
+    struct Hierarchy *pRetired;
+} Hierarchy;
+
+// One step of a cast from a Structure to one of its ancestors: the object is
+// cast through pBase, if it is not NULL, and then offset is added to it.
+// pBase is only needed for a virtual base, whose offset depends upon the
+// most derived type of the object; a run of non-virtual bases is always
+// collapsed into a single offset.
+typedef struct CastStep
+{
+    const Base *pBase;
+    long offset;
+} CastStep;
+
+// How to cast an instance of pFrom to an instance of pTo, as computed once
+// and then cached
+typedef struct CastPath
+{
+    // The generationG of the Hierarchy that it was computed from
+    u32 generation;
+    const Structure *pFrom;
+    const Structure *pTo;
+    // False if pTo is not an unambiguous base of pFrom, or is only reachable
+    // through a Base which is not castable
+    bool isCastable;
+    u32 stepCount;
+    CastStep *pSteps;
+    // CastPaths which have been thrown away
+    struct CastPath *pRetired;
+} CastPath;
+
+// The state of one thread which reads the registry.  gracePeriod is zero
+// when the thread is not in a read section, and otherwise identifies the
+// grace period in which its read section began.  Each Reader is on its own
+// cache line so that readers never write to a shared one.
+typedef struct Reader
+{
+    u32 gracePeriod;
+    // False once the thread has exited and the Reader may be reused
+    bool inUse;
+    struct Reader *pNext;
+    char pad[64 - sizeof(u32) - sizeof(bool) - sizeof(struct Reader *)];
+} Reader;
+
+static pthread_mutex_t registryMutexG = PTHREAD_MUTEX_INITIALIZER;
+
+static Index *pContextsByNameG;
+static Index *pStructuresByTypeinfoG;
+
+static ContextList *pContextListG;
+
+static Duplicate *pDuplicatesG;
+static Duplicate *pRetiredDuplicatesG;
+
+// The batches registered before the registry was first read, newest first,
+// or &indexingG once a reader has claimed them.  Writers push and remove
+// batches with compare and swap, since a reader may claim them at any
+// time.  The claimed batches are left in pIndexedPendingG for writers to
+// free, once indexedG has been set.
+static PendingBatch *pPendingG;
+static PendingBatch indexingG;
+static PendingBatch *pIndexedPendingG;
+static bool indexedG;
+static PendingBatch *pRetiredPendingG;
+
+// Incremented by every change to the registry, once it is complete
+static u32 generationG;
+
+// NULL until it is needed, and whenever the registry has changed since; it
+// may also be left over from an earlier generation.  Readers retire a
+// Hierarchy which they replace, so pRetiredHierarchiesG is pushed onto with
+// compare and swap.
+static Hierarchy *pHierarchyG;
+static Hierarchy *pRetiredHierarchiesG;
+
+// Cache of CastPaths by the addresses of their Structures, using linear
+// probing in a table in which at most half of the slots are ever in use.
+// Each slot holds a single pointer which is read and written atomically.
+// Readers fill in empty slots with compare and swap, having first reserved
+// room by incrementing castCacheCountG, and writers empty all of them at
+// once when the class hierarchy index is thrown away, so readers never
+// lock.
+#define CAST_CACHE_SIZE 1024
+
+static CastPath *castCacheG[CAST_CACHE_SIZE];
+static u32 castCacheCountG;
+static CastPath *pRetiredCastPathsG;
+
+// Every interned Type, by fingerprint; the first one of each fingerprint
+// is the canonical Type of all of them.  Only accessed with registryMutexG
+// held; readers only load the canonical Type that each Type was given.
+static map<TypeFingerprint, vector<Type *> > *pInternedTypesG;
+
+// Set once any Structure has replaced another in the type_info index, after
+// which unregistration must look for a replaced Structure to restore
+static bool typeinfoReplacedG;
+
+static const char tombstoneG[] = "";
+
+static u32 gracePeriodG;
+
+// Every Reader ever created; Readers are reused but never freed, so this
+// list only ever grows at its head
+static pthread_mutex_t readersMutexG = PTHREAD_MUTEX_INITIALIZER;
+static Reader *pReadersG;
+static pthread_once_t readerKeyOnceG = PTHREAD_ONCE_INIT;
+static pthread_key_t readerKeyG;
+static __thread Reader *pThreadReaderG;
+
+// Cache of Structures by type_info address, in front of the type_info name
+// index.  Within a process the type_info object for a type is almost always
+// unique, so a hit avoids hashing and comparing the mangled name.  Each slot
+// holds a single pointer which is read and written atomically, and a hit is
+// verified against the Structure's own type_info, so readers never lock.
+// A type_info which is a duplicate from another shared library never hits,
+// and is always looked up by name.
+#define TYPEINFO_CACHE_SIZE 1024
+
+static Structure *typeinfoCacheG[TYPEINFO_CACHE_SIZE];
+
+// The bounds symbol of the first object which defines one.  The reference
+// to it from here also makes the linker export the executable's definition
+// of it, which dlsym() could not otherwise find.
+extern "C" CompiledRegistration *xrtti_registry_bounds[2] 
+    __attribute__((weak));
+
+// The number of objects that the dynamic linker had loaded when the
+// registration sections were last searched, or 0 if they never have been
+static u32 searchedLoadCountG;
+
+
+// **************************************************************************
+// Read sections and grace periods
+// **************************************************************************
+
+static void release_reader(void *pReader)
+{
+    pthread_mutex_lock(&readersMutexG);
+
+    ((Reader *) pReader)->inUse = false;
+
+    pthread_mutex_unlock(&readersMutexG);
+}
+
+
+static void create_reader_key()
+{
+    pthread_key_create(&readerKeyG, &release_reader);
+}
+
+
+// Returns the Reader of the calling thread, which is released for reuse by
+// another thread when this one exits
+static Reader *get_reader()
+{
+    if (pThreadReaderG) {
+        return pThreadReaderG;
+    }
+
+    pthread_once(&readerKeyOnceG, &create_reader_key);
+
+    pthread_mutex_lock(&readersMutexG);
+
+    Reader *pReader = pReadersG;
+    while (pReader && pReader->inUse) {
+        pReader = pReader->pNext;
+    }
+
+    if (!pReader) {
+        pReader = new Reader;
+        pReader->gracePeriod = 0;
+        pReader->pNext = pReadersG;
+        __atomic_store_n(&pReadersG, pReader, __ATOMIC_RELEASE);
+    }
+
+    pReader->inUse = true;
+
+    pthread_mutex_unlock(&readersMutexG);
+
+    pthread_setspecific(readerKeyG, pReader);
+
+    return (pThreadReaderG = pReader);
+}
+
+
+// Read sections do not nest
+class ReadSection
+{
+public:
+
+    ReadSection()
+        : pReaderM(get_reader())
+    {
+        // The fence orders the store before every read of the registry, so
+        // that either a writer beginning a grace period sees this read
+        // section, or this read section sees everything that the writer
+        // unpublished before beginning it
+        __atomic_store_n(&(pReaderM->gracePeriod), 
+                         (__atomic_load_n(&gracePeriodG, __ATOMIC_RELAXED) 
+                          << 1) | 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    }
+
+    ~ReadSection()
+    {
+        __atomic_store_n(&(pReaderM->gracePeriod), 0, __ATOMIC_RELEASE);
+    }
+
+private:
+
+    Reader *pReaderM;
+};
+
+
+// Must be called with registryMutexG held.  Returns once every read section
+// which was running when this was called has finished.
+static void wait_for_grace_period()
+{
+    u32 gracePeriod = gracePeriodG + 1;
+
+    __atomic_store_n(&gracePeriodG, gracePeriod, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    // Read sections which began in the new grace period cannot be using
+    // anything which was unpublished before it began, so only wait for the
+    // others
+    Reader *pReader = __atomic_load_n(&pReadersG, __ATOMIC_ACQUIRE);
+    while (pReader) {
+        while (true) {
+            u32 readerGracePeriod = 
+                __atomic_load_n(&(pReader->gracePeriod), __ATOMIC_ACQUIRE);
+            if (!readerGracePeriod || 
+                (readerGracePeriod == ((gracePeriod << 1) | 1))) {
+                break;
+            }
+            sched_yield();
+        }
+        pReader = pReader->pNext;
+    }
+}
+
+
+// Must be called with registryMutexG held.  Frees the given Hierarchies,
+// and everything else which writers have retired.
+static void free_retired(Hierarchy *pRetiredHierarchies)
+{
+    // Until the pending batches have been indexed, the reader indexing them
+    // is the writer of the indexes and the list of Contexts
+    if (__atomic_load_n(&indexedG, __ATOMIC_ACQUIRE)) {
+        Index *indexes[2] = { pContextsByNameG, pStructuresByTypeinfoG };
+
+        for (u32 i = 0; i < 2; i++) {
+            if (!indexes[i]) {
+                continue;
+            }
+            Index *pRetired = indexes[i]->pRetired;
+            indexes[i]->pRetired = 0;
+            while (pRetired) {
+                Index *pNext = pRetired->pRetired;
+                delete [] pRetired->pSlots;
+                delete pRetired;
+                pRetired = pNext;
+            }
+        }
+
+        if (pContextListG) {
+            ContextList *pRetired = pContextListG->pRetired;
+            pContextListG->pRetired = 0;
+            while (pRetired) {
+                ContextList *pNext = pRetired->pRetired;
+                delete [] pRetired->pContexts;
+                delete pRetired;
+                pRetired = pNext;
+            }
+        }
+
+        for (PendingBatch *pBatch = pIndexedPendingG; pBatch; 
+             pBatch = pBatch->pNext) {
+            pBatch->pRetired = pRetiredPendingG;
+            pRetiredPendingG = pBatch;
+        }
+        pIndexedPendingG = 0;
+    }
+
+    while (pRetiredHierarchies) {
+        Hierarchy *pNext = pRetiredHierarchies->pRetired;
+        delete [] pRetiredHierarchies->pEntries;
+        delete [] pRetiredHierarchies->pSlots;
+        delete [] pRetiredHierarchies->pWords;
+        delete [] pRetiredHierarchies->pDerived;
+        delete pRetiredHierarchies;
+        pRetiredHierarchies = pNext;
+    }
+
+    while (pRetiredCastPathsG) {
+        CastPath *pNext = pRetiredCastPathsG->pRetired;
+        delete [] pRetiredCastPathsG->pSteps;
+        delete pRetiredCastPathsG;
+        pRetiredCastPathsG = pNext;
+    }
+
+    while (pRetiredDuplicatesG) {
+        Duplicate *pNext = pRetiredDuplicatesG->pRetired;
+        delete pRetiredDuplicatesG;
+        pRetiredDuplicatesG = pNext;
+    }
+
+    while (pRetiredPendingG) {
+        PendingBatch *pNext = pRetiredPendingG->pRetired;
+        delete [] pRetiredPendingG->pContexts;
+        delete pRetiredPendingG;
+        pRetiredPendingG = pNext;
+    }
+}
+
+
+// Must be called with registryMutexG held
+static bool has_retired()
+{
+    if (__atomic_load_n(&indexedG, __ATOMIC_ACQUIRE) &&
+        ((pContextsByNameG && pContextsByNameG->pRetired) ||
+         (pStructuresByTypeinfoG && pStructuresByTypeinfoG->pRetired) ||
+         (pContextListG && pContextListG->pRetired) || pIndexedPendingG)) {
+        return true;
+    }
+
+    return (__atomic_load_n(&pRetiredHierarchiesG, __ATOMIC_ACQUIRE) ||
+            pRetiredCastPathsG || pRetiredDuplicatesG || pRetiredPendingG);
+}
+
+
+// Must be called with registryMutexG held.  Waits for a grace period, and
+// then frees everything which was retired before it began.
+static void reclaim()
+{
+    // Readers retire Hierarchies too, so only those which were retired
+    // before the grace period began may be freed once it has ended
+    Hierarchy *pRetiredHierarchies =
+        __atomic_exchange_n(&pRetiredHierarchiesG, (Hierarchy *) 0,
+                            __ATOMIC_ACQ_REL);
+
+    wait_for_grace_period();
+
+    free_retired(pRetiredHierarchies);
+}
+
+
+// May be called from within a read section, with or without registryMutexG
+// held
+static void hierarchy_retire(Hierarchy *pHierarchy)
+{
+    Hierarchy *pRetired =
+        __atomic_load_n(&pRetiredHierarchiesG, __ATOMIC_RELAXED);
+
+    do {
+        pHierarchy->pRetired = pRetired;
+    } while (!__atomic_compare_exchange_n(&pRetiredHierarchiesG, &pRetired,
+                                          pHierarchy, true, __ATOMIC_RELEASE,
+                                          __ATOMIC_RELAXED));
+}
+
+
+// **************************************************************************
+// static helper functions
+// **************************************************************************
+
+static IndexSlot *index_find(Index *const *ppIndex, u32 hash,
+                             const char *pKey)
+{
+    Index *pIndex = __atomic_load_n(ppIndex, __ATOMIC_ACQUIRE);
+
+    if (!pIndex) {
+        return 0;
+    }
+
+    u32 mask = pIndex->capacity - 1;
+
+    for (u32 i = hash & mask; ; i = (i + 1) & mask) {
+        IndexSlot *pSlot = &(pIndex->pSlots[i]);
+        const char *pSlotKey = __atomic_load_n(&(pSlot->pKey), 
+                                               __ATOMIC_ACQUIRE);
+        if (!pSlotKey) {
+            return 0;
+        }
+        if ((pSlotKey != tombstoneG) && (pSlot->hash == hash) && 
+            !strcmp(pSlotKey, pKey)) {
+            return pSlot;
+        }
+    }
+}
+
+
+static Context *index_lookup(Index *const *ppIndex, u32 hash, 
+                             const char *pKey)
+{
+    IndexSlot *pSlot = index_find(ppIndex, hash, pKey);
+
+    return pSlot ? __atomic_load_n(&(pSlot->pContext), __ATOMIC_ACQUIRE) : 0;
+}
+
+
+// Fills in an empty slot, publishing its key last so that readers never
+// see a partially written slot
+static void index_put(Index *pIndex, u32 hash, const char *pKey, 
+                      Context *pContext, const u32 *pFingerprint)
+{
+    u32 mask = pIndex->capacity - 1;
+    
+    u32 i = hash & mask;
+    while (pIndex->pSlots[i].pKey) {
+        i = (i + 1) & mask;
+    }
+
+    IndexSlot *pSlot = &(pIndex->pSlots[i]);
+    pSlot->hash = hash;
+    pSlot->pContext = pContext;
+    pSlot->pFingerprint = pFingerprint;
+    __atomic_store_n(&(pSlot->pKey), pKey, __ATOMIC_RELEASE);
+
+    pIndex->count++;
+    pIndex->liveCount++;
+}
+
+
+// Must be called with registryMutexG held, or by index_pending().  Makes
+// room in the index for the given number of additional keys.
+static void index_reserve(Index **ppIndex, u32 additional)
+{
+    Index *pIndex = *ppIndex;
+
+    // Replace the index with a copy without tombstones, and larger if
+    // necessary, if it would become more than half full
+    if (!pIndex || ((2 * (pIndex->count + additional)) > pIndex->capacity)) {
+        Index *pNew = new Index;
+        pNew->capacity = 64;
+        while ((2 * ((pIndex ? pIndex->liveCount : 0) + additional)) > 
+               pNew->capacity) {
+            pNew->capacity *= 2;
+        }
+        pNew->count = pNew->liveCount = 0;
+        pNew->pSlots = new IndexSlot[pNew->capacity];
+        memset(pNew->pSlots, 0, pNew->capacity * sizeof(IndexSlot));
+        pNew->pRetired = pIndex;
+        if (pIndex) {
+            for (u32 i = 0; i < pIndex->capacity; i++) {
+                IndexSlot &slot = pIndex->pSlots[i];
+                if (slot.pKey && (slot.pKey != tombstoneG)) {
+                    index_put(pNew, slot.hash, slot.pKey, slot.pContext,
+                              slot.pFingerprint);
+                }
+            }
+        }
+        __atomic_store_n(ppIndex, pNew, __ATOMIC_RELEASE);
+    }
+}
+
+
+// Must be called with registryMutexG held, or by index_pending(), and the
+// key must not already be in the index
+static void index_insert(Index **ppIndex, u32 hash, const char *pKey,
+                         Context *pContext, const u32 *pFingerprint)
+{
+    index_reserve(ppIndex, 1);
+
+    index_put(*ppIndex, hash, pKey, pContext, pFingerprint);
+}
+
+
+// Must be called with registryMutexG held
+static void index_remove(Index *pIndex, IndexSlot *pSlot)
+{
+    __atomic_store_n(&(pSlot->pKey), (const char *) tombstoneG, 
+                     __ATOMIC_RELEASE);
+    __atomic_store_n(&(pSlot->pContext), (Context *) 0, __ATOMIC_RELEASE);
+    pSlot->pFingerprint = 0;
+
+    pIndex->liveCount--;
+}
+
+
+// Must be called with registryMutexG held, or by index_pending()
+static void context_list_append(Context *pContext)
+{
+    ContextList *pList = pContextListG;
+
+    if (!pList || (pList->count == pList->capacity)) {
+        ContextList *pNew = new ContextList;
+        pNew->capacity = pList ? (2 * pList->capacity) : 64;
+        pNew->count = pList ? pList->count : 0;
+        pNew->pContexts = new Context * [pNew->capacity];
+        for (u32 i = 0; i < pNew->count; i++) {
+            pNew->pContexts[i] = pList->pContexts[i];
+        }
+        pNew->pRetired = pList;
+        __atomic_store_n(&pContextListG, pNew, __ATOMIC_RELEASE);
+        pList = pNew;
+    }
+
+    pList->pContexts[pList->count] = pContext;
+
+    __atomic_store_n(&(pList->count), pList->count + 1, __ATOMIC_RELEASE);
+}
+
+
+// Must be called with registryMutexG held.  listedCount is how many of
+// removed are in the list.  If appending is true, then Contexts will be
+// appended to the list before the next grace period.
+static void context_list_remove(const set<Context *> &removed, 
+                                u32 listedCount, bool appending)
+{
+    ContextList *pList = pContextListG;
+
+    if (!pList) {
+        return;
+    }
+
+    // Static destructors unregister in the reverse of the order in which
+    // static constructors registered, both at exit and when a library is
+    // unloaded, so the removed Contexts are almost always the last ones in
+    // the list, which is then just shortened rather than copied.  A reader
+    // which loaded the old count may still read their slots until the
+    // grace period which ends this unregistration, so the list is copied
+    // instead if Contexts are to be appended into those slots before then.
+    u32 tailCount = 0;
+    while ((tailCount < pList->count) && 
+           removed.count(pList->pContexts[pList->count - tailCount - 1])) {
+        tailCount++;
+    }
+
+    if (!appending && (tailCount == listedCount)) {
+        __atomic_store_n(&(pList->count), pList->count - tailCount,
+                         __ATOMIC_RELEASE);
+        return;
+    }
+
+    ContextList *pNew = new ContextList;
+    pNew->capacity = pList->capacity;
+    pNew->count = 0;
+    pNew->pContexts = new Context * [pNew->capacity];
+    for (u32 i = 0; i < pList->count; i++) {
+        if (!removed.count(pList->pContexts[i])) {
+            pNew->pContexts[pNew->count++] = pList->pContexts[i];
+        }
+    }
+    pNew->pRetired = pList;
+
+    __atomic_store_n(&pContextListG, pNew, __ATOMIC_RELEASE);
+}
+
+
+static Structure **typeinfo_cache_slot(const std::type_info *pTypeInfo)
+{
+    // type_info objects are at least pointer aligned, so the low bits carry
+    // no information
+    unsigned long address = (unsigned long) pTypeInfo;
+
+    return &(typeinfoCacheG[((address >> 4) ^ (address >> 14)) & 
+                            (TYPEINFO_CACHE_SIZE - 1)]);
+}
+
+
+// Must be called with registryMutexG held, or by index_pending()
+static void register_typeinfo(Structure *pStructure)
+{
+    const std::type_info *pTypeInfo = pStructure->GetTypeInfo();
+
+    if (!pTypeInfo) {
+        return;
+    }
+
+    // The type_info name is mangled by the compiler, so xrttigen cannot
+    // know it, and it is hashed here instead
+    const char *pName = pTypeInfo->name();
+    u32 hash = CompiledContextSet::Hash(pName);
+    IndexSlot *pSlot = index_find(&pStructuresByTypeinfoG, hash, pName);
+    if (pSlot) {
+        // Make sure that the cache does not keep returning the Structure
+        // that is being replaced
+        const std::type_info *pReplacedTypeInfo =
+            ((Structure *) pSlot->pContext)->GetTypeInfo();
+        __atomic_store_n(&(pSlot->pContext), pStructure, __ATOMIC_RELEASE);
+        __atomic_store_n(&(pSlot->pKey), pName, __ATOMIC_RELEASE);
+        __atomic_store_n(typeinfo_cache_slot(pReplacedTypeInfo), 
+                         (Structure *) 0, __ATOMIC_RELEASE);
+        typeinfoReplacedG = true;
+    }
+    else {
+        index_insert(&pStructuresByTypeinfoG, hash, pName, pStructure, 0);
+    }
+}
+
+
+// Must be called with registryMutexG held, once a change to the registry
+// is complete.  Starts a new generation, and throws away the class
+// hierarchy index and every CastPath cached from it.  A reader which is
+// still building either from the previous generation will publish it, but
+// it will never be used.
+static void hierarchy_invalidate()
+{
+    __atomic_store_n(&generationG, generationG + 1, __ATOMIC_RELEASE);
+
+    Hierarchy *pHierarchy =
+        __atomic_exchange_n(&pHierarchyG, (Hierarchy *) 0, __ATOMIC_ACQ_REL);
+    if (pHierarchy) {
+        hierarchy_retire(pHierarchy);
+    }
+
+    if (!__atomic_load_n(&castCacheCountG, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+
+    for (u32 i = 0; i < CAST_CACHE_SIZE; i++) {
+        CastPath *pPath = __atomic_exchange_n(&(castCacheG[i]),
+                                              (CastPath *) 0,
+                                              __ATOMIC_ACQ_REL);
+        if (pPath) {
+            pPath->pRetired = pRetiredCastPathsG;
+            pRetiredCastPathsG = pPath;
+            __atomic_fetch_sub(&castCacheCountG, 1, __ATOMIC_RELEASE);
+        }
+    }
+}
+
+
+static u32 hierarchy_hash(const Structure *pStructure)
+{
+    // Structures are at least pointer aligned, so the low bits carry no
+    // information
+    unsigned long address = (unsigned long) pStructure;
+
+    return (u32) ((address >> 4) ^ (address >> 20));
+}
+
+
+// Returns the index of the entry of the Structure, or HIERARCHY_NO_BIT if
+// it is not registered
+static u32 hierarchy_find(const Hierarchy *pHierarchy, 
+                          const Structure *pStructure)
+{
+    u32 mask = pHierarchy->capacity - 1;
+
+    for (u32 i = hierarchy_hash(pStructure) & mask; 
+         pHierarchy->pSlots[i].pStructure; i = (i + 1) & mask) {
+        if (pHierarchy->pSlots[i].pStructure == pStructure) {
+            return pHierarchy->pSlots[i].entry;
+        }
+    }
+
+    return HIERARCHY_NO_BIT;
+}
+
+
+static void hierarchy_put(Hierarchy *pHierarchy, const Structure *pStructure,
+                          u32 entry)
+{
+    u32 mask = pHierarchy->capacity - 1;
+
+    u32 i = hierarchy_hash(pStructure) & mask;
+    while (pHierarchy->pSlots[i].pStructure) {
+        i = (i + 1) & mask;
+    }
+
+    pHierarchy->pSlots[i].pStructure = pStructure;
+    pHierarchy->pSlots[i].entry = entry;
+}
+
+
+static bool hierarchy_is_subclass(const Hierarchy *pHierarchy, u32 entry,
+                                  u32 baseEntry)
+{
+    u32 bit = pHierarchy->pEntries[baseEntry].bit;
+    const HierarchyEntry &derived = pHierarchy->pEntries[entry];
+
+    return ((bit != HIERARCHY_NO_BIT) && 
+            ((bit / 32) < derived.ancestorWordCount) &&
+            (derived.pAncestors[bit / 32] & (1UL << (bit % 32))));
+}
+
+
+// Computes into vvAncestors[entry] the set of the bits of every ancestor of
+// the entry's Structure, having first computed those of its bases
+static void hierarchy_ancestors(const Hierarchy *pHierarchy, u32 entry,
+                                vector<vector<u32> > &vvAncestors,
+                                vector<bool> &vDone)
+{
+    if (vDone[entry]) {
+        return;
+    }
+
+    vDone[entry] = true;
+
+    const Structure *pStructure = pHierarchy->pEntries[entry].pStructure;
+    vector<u32> &vAncestors = vvAncestors[entry];
+
+    u32 count = pStructure->GetBaseCount();
+    for (u32 i = 0; i < count; i++) {
+        u32 base = hierarchy_find
+            (pHierarchy, &(pStructure->GetBase(i).GetStructure()));
+        if (base == HIERARCHY_NO_BIT) {
+            continue;
+        }
+        hierarchy_ancestors(pHierarchy, base, vvAncestors, vDone);
+        const vector<u32> &vBaseAncestors = vvAncestors[base];
+        if (vAncestors.size() < vBaseAncestors.size()) {
+            vAncestors.resize(vBaseAncestors.size(), 0);
+        }
+        for (u32 j = 0; j < vBaseAncestors.size(); j++) {
+            vAncestors[j] |= vBaseAncestors[j];
+        }
+        u32 bit = pHierarchy->pEntries[base].bit;
+        if (vAncestors.size() <= (bit / 32)) {
+            vAncestors.resize((bit / 32) + 1, 0);
+        }
+        vAncestors[bit / 32] |= (1UL << (bit % 32));
+    }
+}
+
+
+// Must be called from within a read section.  Builds the class hierarchy
+// index from the registry as it is now, which is the given generation or a
+// later one.
+static Hierarchy *hierarchy_build(u32 generation)
+{
+    ContextList *pList = __atomic_load_n(&pContextListG, __ATOMIC_ACQUIRE);
+    u32 listCount = pList ? __atomic_load_n(&(pList->count), __ATOMIC_ACQUIRE)
+        : 0;
+
+    vector<const Structure *> vStructures;
+    for (u32 i = 0; i < listCount; i++) {
+        if (pList->pContexts[i]->GetType() != Context::Type_Namespace) {
+            vStructures.push_back((const Structure *) pList->pContexts[i]);
+        }
+    }
+
+    vector<const Structure *> vDuplicates;
+    for (Duplicate *pDuplicate = 
+             __atomic_load_n(&pDuplicatesG, __ATOMIC_ACQUIRE); pDuplicate; 
+         pDuplicate = __atomic_load_n(&(pDuplicate->pNext), 
+                                      __ATOMIC_ACQUIRE)) {
+        if (pDuplicate->pContext->GetType() != Context::Type_Namespace) {
+            vDuplicates.push_back((const Structure *) pDuplicate->pContext);
+        }
+    }
+
+    u32 count = vStructures.size();
+
+    Hierarchy *pHierarchy = new Hierarchy;
+    pHierarchy->generation = generation;
+    pHierarchy->pEntries = new HierarchyEntry[count ? count : 1];
+    pHierarchy->capacity = 64;
+    while (pHierarchy->capacity < 
+           (2 * (count + vDuplicates.size()))) {
+        pHierarchy->capacity *= 2;
+    }
+    pHierarchy->pSlots = new HierarchySlot[pHierarchy->capacity];
+    memset(pHierarchy->pSlots, 0, 
+           pHierarchy->capacity * sizeof(HierarchySlot));
+    pHierarchy->pRetired = 0;
+
+    for (u32 i = 0; i < count; i++) {
+        HierarchyEntry &entry = pHierarchy->pEntries[i];
+        entry.pStructure = vStructures[i];
+        entry.bit = HIERARCHY_NO_BIT;
+        entry.derivedCount = 0;
+        hierarchy_put(pHierarchy, vStructures[i], i);
+    }
+
+    // A duplicate shares the entry of the Structure which was indexed in
+    // its place
+    for (u32 i = 0; i < vDuplicates.size(); i++) {
+        const Context *pIndexed = index_lookup
+            (&pContextsByNameG, 
+             CompiledContextSet::Hash(vDuplicates[i]->GetFullName()),
+             vDuplicates[i]->GetFullName());
+        u32 entry = pIndexed ? 
+            hierarchy_find(pHierarchy, (const Structure *) pIndexed) :
+            HIERARCHY_NO_BIT;
+        if (entry != HIERARCHY_NO_BIT) {
+            hierarchy_put(pHierarchy, vDuplicates[i], entry);
+        }
+    }
+
+    // Count the subclasses of each Structure, and give a bit to each
+    // Structure which has any
+    u32 bitCount = 0, derivedCount = 0;
+    for (u32 i = 0; i < count; i++) {
+        const Structure *pStructure = vStructures[i];
+        u32 baseCount = pStructure->GetBaseCount();
+        for (u32 j = 0; j < baseCount; j++) {
+            u32 base = hierarchy_find
+                (pHierarchy, &(pStructure->GetBase(j).GetStructure()));
+            if (base == HIERARCHY_NO_BIT) {
+                continue;
+            }
+            HierarchyEntry &baseEntry = pHierarchy->pEntries[base];
+            if (baseEntry.bit == HIERARCHY_NO_BIT) {
+                baseEntry.bit = bitCount++;
+            }
+            baseEntry.derivedCount++;
+            derivedCount++;
+        }
+    }
+
+    vector<vector<u32> > vvAncestors(count);
+    vector<bool> vDone(count, false);
+    u32 wordCount = 0;
+    for (u32 i = 0; i < count; i++) {
+        hierarchy_ancestors(pHierarchy, i, vvAncestors, vDone);
+        wordCount += vvAncestors[i].size();
+    }
+
+    pHierarchy->pWords = new u32[wordCount ? wordCount : 1];
+    pHierarchy->pDerived = new const Structure * 
+        [derivedCount ? derivedCount : 1];
+
+    for (u32 i = 0, word = 0, derived = 0; i < count; i++) {
+        HierarchyEntry &entry = pHierarchy->pEntries[i];
+        const vector<u32> &vAncestors = vvAncestors[i];
+        entry.ancestorWordCount = vAncestors.size();
+        entry.pAncestors = &(pHierarchy->pWords[word]);
+        for (u32 j = 0; j < vAncestors.size(); j++) {
+            pHierarchy->pWords[word++] = vAncestors[j];
+        }
+        entry.pDerived = &(pHierarchy->pDerived[derived]);
+        derived += entry.derivedCount;
+        // Counted again as the subclasses are filled in below
+        entry.derivedCount = 0;
+    }
+
+    for (u32 i = 0; i < count; i++) {
+        const Structure *pStructure = vStructures[i];
+        u32 baseCount = pStructure->GetBaseCount();
+        for (u32 j = 0; j < baseCount; j++) {
+            u32 base = hierarchy_find
+                (pHierarchy, &(pStructure->GetBase(j).GetStructure()));
+            if (base != HIERARCHY_NO_BIT) {
+                HierarchyEntry &baseEntry = pHierarchy->pEntries[base];
+                baseEntry.pDerived[baseEntry.derivedCount++] = pStructure;
+            }
+        }
+    }
+
+    return pHierarchy;
+}
+
+
+// Must be called from within a read section.  Returns the class hierarchy
+// index of the current generation, building and publishing it first if it
+// has not been built since the registry last changed.
+static const Hierarchy *hierarchy_get()
+{
+    u32 generation = __atomic_load_n(&generationG, __ATOMIC_ACQUIRE);
+
+    Hierarchy *pHierarchy = __atomic_load_n(&pHierarchyG, __ATOMIC_ACQUIRE);
+
+    if (pHierarchy && (pHierarchy->generation == generation)) {
+        return pHierarchy;
+    }
+
+    Hierarchy *pNew = hierarchy_build(generation);
+
+    // Replace whatever was there, which other readers may still be using;
+    // if another reader has published one first, this one is used only by
+    // this reader, and is retired all the same
+    if (__atomic_compare_exchange_n(&pHierarchyG, &pHierarchy, pNew, false,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        if (pHierarchy) {
+            hierarchy_retire(pHierarchy);
+        }
+    }
+    else {
+        hierarchy_retire(pNew);
+    }
+
+    return pNew;
+}
+
+
+// Identifies a Structure within the class hierarchy, so that duplicates of
+// the same Structure registered from different generated files are the same
+static unsigned long cast_identity(const Hierarchy *pHierarchy,
+                                   const Structure *pStructure)
+{
+    u32 entry = hierarchy_find(pHierarchy, pStructure);
+
+    return ((entry == HIERARCHY_NO_BIT) ? (unsigned long) pStructure :
+            (unsigned long) entry);
+}
+
+
+// Appends to vvPaths every path of Bases from structure up to the Structure
+// identified by to.  Bases which the class hierarchy index knows cannot
+// lead to it are not followed.
+static void cast_find_paths(const Hierarchy *pHierarchy,
+                            const Structure &structure, unsigned long to,
+                            u32 toEntry, vector<const Base *> &vPath,
+                            vector<vector<const Base *> > &vvPaths)
+{
+    u32 count = structure.GetBaseCount();
+    for (u32 i = 0; i < count; i++) {
+        const Base &base = structure.GetBase(i);
+        const Structure &baseStructure = base.GetStructure();
+        vPath.push_back(&base);
+        if (cast_identity(pHierarchy, &baseStructure) == to) {
+            vvPaths.push_back(vPath);
+        }
+        else {
+            u32 entry = hierarchy_find(pHierarchy, &baseStructure);
+            if ((entry == HIERARCHY_NO_BIT) || (toEntry == HIERARCHY_NO_BIT) ||
+                hierarchy_is_subclass(pHierarchy, entry, toEntry)) {
+                cast_find_paths(pHierarchy, baseStructure, to, toEntry, vPath,
+                                vvPaths);
+            }
+        }
+        vPath.pop_back();
+    }
+}
+
+
+// Identifies the base subobject which a path of Bases leads to.  Paths
+// which end in the same non-virtual run of Bases after the same virtual
+// base lead to the same subobject, which is shared.
+static vector<unsigned long> cast_subobject
+    (const Hierarchy *pHierarchy, const Structure &from,
+     const vector<const Base *> &vPath)
+{
+    // The path starts at from, or at its last virtual base
+    const Structure *pStart = &from;
+    u32 start = 0;
+    for (u32 i = 0; i < vPath.size(); i++) {
+        if (vPath[i]->IsVirtual()) {
+            pStart = &(vPath[i]->GetStructure());
+            start = i + 1;
+        }
+    }
+
+    vector<unsigned long> vSubobject;
+    vSubobject.push_back(cast_identity(pHierarchy, pStart));
+    for (u32 i = start; i < vPath.size(); i++) {
+        vSubobject.push_back(cast_identity
+                             (pHierarchy, &(vPath[i]->GetStructure())));
+    }
+
+    return vSubobject;
+}
+
+
+// Must be called from within a read section.  Computes how to cast pObject,
+// which must be an instance of from, to an instance of to, by casting it
+// through each Base of the path in turn.  The offset of a non-virtual Base
+// is the same for every instance, and is measured along the way if xrttigen
+// did not give it.
+static CastPath *cast_path_create(const Hierarchy *pHierarchy, void *pObject,
+                                  const Structure &from, const Structure &to)
+{
+    CastPath *pPath = new CastPath;
+    pPath->generation = pHierarchy->generation;
+    pPath->pFrom = &from;
+    pPath->pTo = &to;
+    pPath->isCastable = false;
+    pPath->stepCount = 0;
+    pPath->pSteps = 0;
+    pPath->pRetired = 0;
+
+    unsigned long toIdentity = cast_identity(pHierarchy, &to);
+
+    if (cast_identity(pHierarchy, &from) == toIdentity) {
+        pPath->isCastable = true;
+        return pPath;
+    }
+
+    vector<const Base *> vPath;
+    vector<vector<const Base *> > vvPaths;
+    cast_find_paths(pHierarchy, from, toIdentity, 
+                    hierarchy_find(pHierarchy, &to), vPath, vvPaths);
+
+    // Every path must lead to the same subobject, and any one of them which
+    // is castable all of the way may be used
+    const vector<const Base *> *pCastable = 0;
+    for (u32 i = 0; i < vvPaths.size(); i++) {
+        if (cast_subobject(pHierarchy, from, vvPaths[i]) !=
+            cast_subobject(pHierarchy, from, vvPaths[0])) {
+            return pPath;
+        }
+        bool isCastable = true;
+        for (u32 j = 0; j < vvPaths[i].size(); j++) {
+            isCastable = isCastable && vvPaths[i][j]->IsCastable();
+        }
+        if (isCastable && !pCastable) {
+            pCastable = &(vvPaths[i]);
+        }
+    }
+
+    if (!pCastable) {
+        return pPath;
+    }
+
+    vector<CastStep> vSteps;
+    CastStep step = { 0, 0 };
+    char *pCurrent = (char *) pObject;
+    for (u32 i = 0; i < pCastable->size(); i++) {
+        const Base *pBase = (*pCastable)[i];
+        char *pNext = pBase->HasOffset() ? (pCurrent + pBase->GetOffset()) :
+            (char *) pBase->CastSubclass(pCurrent);
+        if (pBase->IsVirtual()) {
+            if (step.pBase || step.offset) {
+                vSteps.push_back(step);
+            }
+            step.pBase = pBase;
+            step.offset = 0;
+        }
+        else {
+            step.offset += pNext - pCurrent;
+        }
+        pCurrent = pNext;
+    }
+    vSteps.push_back(step);
+
+    pPath->isCastable = true;
+    pPath->stepCount = vSteps.size();
+    pPath->pSteps = new CastStep[vSteps.size()];
+    for (u32 i = 0; i < vSteps.size(); i++) {
+        pPath->pSteps[i] = vSteps[i];
+    }
+
+    return pPath;
+}
+
+
+static void *cast_apply(const CastPath *pPath, void *pObject)
+{
+    if (!pPath->isCastable) {
+        return 0;
+    }
+
+    char *pCurrent = (char *) pObject;
+    for (u32 i = 0; i < pPath->stepCount; i++) {
+        const CastStep &step = pPath->pSteps[i];
+        if (step.pBase) {
+            pCurrent = (char *) step.pBase->CastSubclass(pCurrent);
+        }
+        pCurrent += step.offset;
+    }
+
+    return pCurrent;
+}
+
+
+static u32 cast_cache_hash(const Structure *pFrom, const Structure *pTo)
+{
+    return (hierarchy_hash(pFrom) ^ (hierarchy_hash(pTo) * 31));
+}
+
+
+// Must be called from within a read section.  Returns the CastPath from
+// pFrom to pTo cached in the current generation, or NULL if there is none.
+static const CastPath *cast_cache_lookup(const Structure *pFrom, 
+                                         const Structure *pTo)
+{
+    u32 generation = __atomic_load_n(&generationG, __ATOMIC_ACQUIRE);
+
+    for (u32 i = cast_cache_hash(pFrom, pTo) % CAST_CACHE_SIZE; ;
+         i = (i + 1) % CAST_CACHE_SIZE) {
+        const CastPath *pPath = 
+            __atomic_load_n(&(castCacheG[i]), __ATOMIC_ACQUIRE);
+        if (!pPath) {
+            return 0;
+        }
+        // One from an earlier generation may have been inserted after the
+        // cache was emptied, and is skipped
+        if ((pPath->pFrom == pFrom) && (pPath->pTo == pTo) &&
+            (pPath->generation == generation)) {
+            return pPath;
+        }
+    }
+}
+
+
+// Must be called from within a read section.  Returns false if the cache
+// is full, in which case the caller still owns pPath.
+static bool cast_cache_insert(CastPath *pPath)
+{
+    if (__atomic_fetch_add(&castCacheCountG, 1, __ATOMIC_ACQ_REL) >=
+        (CAST_CACHE_SIZE / 2)) {
+        __atomic_fetch_sub(&castCacheCountG, 1, __ATOMIC_RELEASE);
+        return false;
+    }
+
+    // There is room for it, but other readers may be filling in slots too
+    for (u32 i = cast_cache_hash(pPath->pFrom, pPath->pTo) % CAST_CACHE_SIZE;
+         ; i = (i + 1) % CAST_CACHE_SIZE) {
+        CastPath *pEmpty = 0;
+        if (__atomic_compare_exchange_n(&(castCacheG[i]), &pEmpty, pPath,
+                                        false, __ATOMIC_RELEASE, 
+                                        __ATOMIC_RELAXED)) {
+            return true;
+        }
+    }
+}
+
+
+// Must be called with registryMutexG held, or by index_pending()
+static void register_context(Context *pContext, u32 hash,
+                             const u32 *pFingerprint)
+{
+    if ((pContext->GetType() == Context::Type_Namespace) ||
+        !((Structure *) pContext)->IsAnonymous()) {
+        const char *pFullName = pContext->GetFullName();
+        IndexSlot *pExisting = index_find(&pContextsByNameG, hash, pFullName);
+        if (pExisting) {
+            bool equal;
+            // Every shared library which includes a common header
+            // registers its own copy of the same contexts, so this is
+            // common, and fingerprints make it cheap.  Only contexts which
+            // were registered without a fingerprint are compared deeply.
+            if (pFingerprint && pExisting->pFingerprint) {
+                equal = !memcmp(pFingerprint, pExisting->pFingerprint,
+                                4 * sizeof(u32));
+            }
+            else switch (pContext->GetType()) {
+            case Context::Type_Class:
+                equal = (*((Class *) pContext) == *(pExisting->pContext));
+                break;
+            case Context::Type_Namespace:
+                equal = (*((Namespace *) pContext) == 
+                         *(pExisting->pContext));
+                break;
+            case Context::Type_Struct:
+                equal = (*((Struct *) pContext) == *(pExisting->pContext));
+                break;
+            default: // Context::Type_Union
+                equal = (*((Union *) pContext) == *(pExisting->pContext));
+                break;
+            }
+            if (!equal) {
+                // This is bad - mismatch
+                fprintf(stderr, "Mismatched Contexts for %s\n", pFullName);
+                exit(-1);
+            }
+            // Remember it, in case the existing one is unregistered
+            Duplicate *pDuplicate = new Duplicate;
+            pDuplicate->pContext = pContext;
+            pDuplicate->hash = hash;
+            pDuplicate->pFingerprint = pFingerprint;
+            pDuplicate->pNext = pDuplicatesG;
+            pDuplicate->pRetired = 0;
+            __atomic_store_n(&pDuplicatesG, pDuplicate, __ATOMIC_RELEASE);
+            return;
+        }
+        
+        index_insert(&pContextsByNameG, hash, pFullName, pContext, 
+                     pFingerprint);
+    }
+        
+    if (pContext->GetType() != Context::Type_Namespace) {
+        register_typeinfo((Structure *) pContext);
+    }
+
+    context_list_append(pContext);
+}
+
+
+// Must be called with registryMutexG held
+static void unregister_context(Context *pContext, u32 hash)
+{
+    if ((pContext->GetType() == Context::Type_Namespace) ||
+        !((Structure *) pContext)->IsAnonymous()) {
+        IndexSlot *pSlot = index_find(&pContextsByNameG, hash, 
+                                      pContext->GetFullName());
+        if (pSlot && (pSlot->pContext == pContext)) {
+            index_remove(pContextsByNameG, pSlot);
+        }
+    }
+
+    if (pContext->GetType() != Context::Type_Namespace) {
+        const std::type_info *pTypeInfo = 
+            ((Structure *) pContext)->GetTypeInfo();
+        if (pTypeInfo) {
+            const char *pName = pTypeInfo->name();
+            IndexSlot *pSlot = index_find
+                (&pStructuresByTypeinfoG, CompiledContextSet::Hash(pName), 
+                 pName);
+            if (pSlot && (pSlot->pContext == pContext)) {
+                index_remove(pStructuresByTypeinfoG, pSlot);
+            }
+            __atomic_store_n(typeinfo_cache_slot(pTypeInfo), 
+                             (Structure *) 0, __ATOMIC_RELEASE);
+        }
+    }
+}
+
+
+// The CompiledType which holds the canonical Type of pType
+static CompiledType &compiled_type(Type *pType)
+{
+    switch (pType->GetBaseType()) {
+    case Type::BaseType_Enumeration:
+        return ((CompiledTypeEnumeration *) pType)->GetCompiledType();
+    case Type::BaseType_Function:
+        return ((CompiledTypeFunction *) pType)->GetCompiledType();
+    case Type::BaseType_Structure:
+        return ((CompiledTypeStructure *) pType)->GetCompiledType();
+    default:
+        return *((CompiledType *) pType);
+    }
+}
+
+
+static TypeFingerprint type_fingerprint(const u32 *pFingerprint)
+{
+    TypeFingerprint fingerprint;
+
+    memcpy(fingerprint.words, pFingerprint, sizeof(fingerprint.words));
+
+    return fingerprint;
+}
+
+
+// Must be called with registryMutexG held.  Interning only changes what
+// canonical Type each Type has, which readers load atomically, so there is
+// nothing for them to let go of.
+static void register_types(u32 typeCount, Type **pTypes, 
+                           const u32 *pFingerprints)
+{
+    if (!typeCount) {
+        return;
+    }
+
+    if (!pInternedTypesG) {
+        pInternedTypesG = new map<TypeFingerprint, vector<Type *> >;
+    }
+
+    for (u32 i = 0; i < typeCount; i++) {
+        vector<Type *> &types = 
+            (*pInternedTypesG)[type_fingerprint(&(pFingerprints[4 * i]))];
+        types.push_back(pTypes[i]);
+        compiled_type(pTypes[i]).SetCanonical(types[0]);
+    }
+}
+
+
+// Must be called with registryMutexG held; the caller must wait for a grace
+// period before the unregistered Types may be destroyed.  Any Type which
+// was the canonical Type of others is replaced as such by the next of them.
+static void unregister_types(u32 typeCount, Type **pTypes,
+                             const u32 *pFingerprints)
+{
+    if (!pInternedTypesG) {
+        return;
+    }
+
+    for (u32 i = 0; i < typeCount; i++) {
+        map<TypeFingerprint, vector<Type *> >::iterator iter = 
+            pInternedTypesG->find(type_fingerprint(&(pFingerprints[4 * i])));
+        if (iter == pInternedTypesG->end()) {
+            continue;
+        }
+        vector<Type *> &types = iter->second;
+        vector<Type *>::iterator found = 
+            find(types.begin(), types.end(), pTypes[i]);
+        if (found == types.end()) {
+            continue;
+        }
+        bool wasCanonical = (found == types.begin());
+        types.erase(found);
+        if (types.empty()) {
+            pInternedTypesG->erase(iter);
+        }
+        else if (wasCanonical) {
+            for (u32 j = 0; j < types.size(); j++) {
+                compiled_type(types[j]).SetCanonical(types[0]);
+            }
+        }
+    }
+}
+
+
+// Returns once the pending batches, which a reader has claimed, have been
+// indexed.  That reader never waits for anything, so this is never long.
+static void wait_for_indexed()
+{
+    while (!__atomic_load_n(&indexedG, __ATOMIC_ACQUIRE)) {
+        sched_yield();
+    }
+}
+
+
+// Called by every reader, within its read section, before it reads any
+// index.  The first reader to get here indexes every pending batch, all at
+// once; any other which gets here before it has finished waits for it.
+static void index_pending()
+{
+    if (__atomic_load_n(&indexedG, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+
+    PendingBatch *pPending = __atomic_load_n(&pPendingG, __ATOMIC_ACQUIRE);
+
+    do {
+        if (pPending == &indexingG) {
+            wait_for_indexed();
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(&pPendingG, &pPending, &indexingG,
+                                          false, __ATOMIC_ACQUIRE,
+                                          __ATOMIC_ACQUIRE));
+
+    // Size the name index for all of them at once, and index them in the
+    // order in which they were registered, so that the first of any
+    // duplicates is the one indexed
+    vector<PendingBatch *> vBatches;
+    u32 count = 0;
+    for (PendingBatch *pBatch = pPending; pBatch; pBatch = pBatch->pNext) {
+        vBatches.push_back(pBatch);
+        count += pBatch->contextCount;
+    }
+
+    index_reserve(&pContextsByNameG, count);
+
+    for (u32 i = vBatches.size(); i-- > 0; ) {
+        for (u32 j = 0; j < vBatches[i]->contextCount; j++) {
+            PendingContext &pending = vBatches[i]->pContexts[j];
+            register_context(pending.pContext, pending.hash, 
+                             pending.pFingerprint);
+        }
+    }
+
+    pIndexedPendingG = pPending;
+
+    __atomic_store_n(&indexedG, true, __ATOMIC_RELEASE);
+}
+
+
+// Must be called with registryMutexG held.  Pushes the Contexts onto
+// pPendingG, unless a reader has already claimed it, in which case this
+// returns false.
+static bool pending_push(u32 contextCount, Context **pContexts,
+                         const u32 *pHashes, const u32 *pFingerprints)
+{
+    PendingBatch *pPending = __atomic_load_n(&pPendingG, __ATOMIC_ACQUIRE);
+
+    if (pPending == &indexingG) {
+        return false;
+    }
+
+    PendingBatch *pBatch = new PendingBatch;
+    pBatch->contextCount = contextCount;
+    pBatch->pContexts = new PendingContext[contextCount];
+    for (u32 i = 0; i < contextCount; i++) {
+        PendingContext &pending = pBatch->pContexts[i];
+        pending.pContext = pContexts[i];
+        pending.hash = pHashes[i];
+        pending.pFingerprint = pFingerprints ? &(pFingerprints[4 * i]) : 0;
+    }
+    pBatch->pRetired = 0;
+
+    do {
+        if (pPending == &indexingG) {
+            delete [] pBatch->pContexts;
+            delete pBatch;
+            return false;
+        }
+        pBatch->pNext = pPending;
+    } while (!__atomic_compare_exchange_n(&pPendingG, &pPending, pBatch,
+                                          false, __ATOMIC_RELEASE,
+                                          __ATOMIC_ACQUIRE));
+
+    return true;
+}
+
+
+// Must be called with registryMutexG held.  Removes the Contexts from
+// pPendingG, unless a reader has already claimed it, in which case this
+// returns false.  The removed batches are retired, since a reader may have
+// loaded pPendingG before they were removed.
+static bool pending_remove(const set<Context *> &removed)
+{
+    PendingBatch *pPending = __atomic_load_n(&pPendingG, __ATOMIC_ACQUIRE);
+
+    while (pPending != &indexingG) {
+        // Static destructors unregister in the reverse of the order in
+        // which static constructors registered, so the removed Contexts
+        // are almost always the newest batches, which are then just
+        // unlinked; otherwise every surviving Context is copied into a
+        // single new batch
+        u32 prefixCount = 0;
+        PendingBatch *pRest = pPending;
+        while (pRest && (prefixCount < removed.size())) {
+            u32 i = 0;
+            while ((i < pRest->contextCount) &&
+                   removed.count(pRest->pContexts[i].pContext)) {
+                i++;
+            }
+            if (i < pRest->contextCount) {
+                break;
+            }
+            prefixCount += pRest->contextCount;
+            pRest = pRest->pNext;
+        }
+
+        PendingBatch *pReplacement = pRest;
+
+        if (prefixCount != removed.size()) {
+            vector<PendingBatch *> vBatches;
+            for (PendingBatch *pBatch = pPending; pBatch; 
+                 pBatch = pBatch->pNext) {
+                vBatches.push_back(pBatch);
+            }
+            vector<PendingContext> vSurvivors;
+            for (u32 i = vBatches.size(); i-- > 0; ) {
+                for (u32 j = 0; j < vBatches[i]->contextCount; j++) {
+                    PendingContext &pending = vBatches[i]->pContexts[j];
+                    if (!removed.count(pending.pContext)) {
+                        vSurvivors.push_back(pending);
+                    }
+                }
+            }
+            pRest = 0;
+            pReplacement = 0;
+            if (!vSurvivors.empty()) {
+                pReplacement = new PendingBatch;
+                pReplacement->contextCount = vSurvivors.size();
+                pReplacement->pContexts = 
+                    new PendingContext[vSurvivors.size()];
+                copy(vSurvivors.begin(), vSurvivors.end(), 
+                     pReplacement->pContexts);
+                pReplacement->pNext = 0;
+                pReplacement->pRetired = 0;
+            }
+        }
+
+        PendingBatch *pRemoved = pPending;
+
+        if (__atomic_compare_exchange_n(&pPendingG, &pPending, pReplacement,
+                                        false, __ATOMIC_RELEASE,
+                                        __ATOMIC_ACQUIRE)) {
+            while (pRemoved != pRest) {
+                pRemoved->pRetired = pRetiredPendingG;
+                pRetiredPendingG = pRemoved;
+                pRemoved = pRemoved->pNext;
+            }
+            return true;
+        }
+
+        if (pReplacement && (pReplacement != pRest)) {
+            delete [] pReplacement->pContexts;
+            delete pReplacement;
+        }
+    }
+
+    return false;
+}
+
+
+// Must be called with registryMutexG held
+static void register_contexts(u32 contextCount, Context **pContexts,
+                              const u32 *pHashes, const u32 *pFingerprints)
+{
+    if (!contextCount || 
+        pending_push(contextCount, pContexts, pHashes, pFingerprints)) {
+        return;
+    }
+
+    wait_for_indexed();
+
+    // Size the name index for all of them at once, rather than growing it
+    // repeatedly
+    index_reserve(&pContextsByNameG, contextCount);
+
+    for (u32 i = 0; i < contextCount; i++) {
+        register_context(pContexts[i], pHashes[i], 
+                         pFingerprints ? &(pFingerprints[4 * i]) : 0);
+    }
+
+    hierarchy_invalidate();
+}
+
+
+// Must be called with registryMutexG held; the caller must wait for a grace
+// period before the unregistered Contexts may be destroyed
+static void unregister_contexts(u32 contextCount, Context **pContexts,
+                                const u32 *pHashes)
+{
+    set<Context *> removed(pContexts, pContexts + contextCount);
+
+    // Contexts which were never indexed are just forgotten
+    if (pending_remove(removed)) {
+        return;
+    }
+
+    wait_for_indexed();
+
+    // Forget any of these which were duplicates, since they were never
+    // indexed, nor put in the list of Contexts
+    u32 listedCount = removed.size();
+    Duplicate **ppDuplicate = &pDuplicatesG;
+    while (*ppDuplicate) {
+        Duplicate *pDuplicate = *ppDuplicate;
+        if (removed.count(pDuplicate->pContext)) {
+            __atomic_store_n(ppDuplicate, pDuplicate->pNext, 
+                             __ATOMIC_RELEASE);
+            pDuplicate->pRetired = pRetiredDuplicatesG;
+            pRetiredDuplicatesG = pDuplicate;
+            listedCount--;
+        }
+        else {
+            ppDuplicate = &(pDuplicate->pNext);
+        }
+    }
+
+    for (u32 i = 0; i < contextCount; i++) {
+        unregister_context(pContexts[i], pHashes ? pHashes[i] : 
+                           CompiledContextSet::Hash
+                           (pContexts[i]->GetFullName()));
+    }
+
+    // Any duplicates of what was just unregistered are registered in its
+    // place, so are appended to the list of Contexts
+    bool appending = false;
+    for (Duplicate *pDuplicate = pDuplicatesG; pDuplicate && !appending;
+         pDuplicate = pDuplicate->pNext) {
+        appending = !index_lookup(&pContextsByNameG, pDuplicate->hash,
+                                  pDuplicate->pContext->GetFullName());
+    }
+
+    context_list_remove(removed, listedCount, appending);
+
+    ppDuplicate = &pDuplicatesG;
+    while (*ppDuplicate) {
+        Duplicate *pDuplicate = *ppDuplicate;
+        if (!index_lookup(&pContextsByNameG, pDuplicate->hash,
+                          pDuplicate->pContext->GetFullName())) {
+            __atomic_store_n(ppDuplicate, pDuplicate->pNext, 
+                             __ATOMIC_RELEASE);
+            pDuplicate->pRetired = pRetiredDuplicatesG;
+            pRetiredDuplicatesG = pDuplicate;
+            register_context(pDuplicate->pContext, pDuplicate->hash,
+                             pDuplicate->pFingerprint);
+        }
+        else {
+            ppDuplicate = &(pDuplicate->pNext);
+        }
+    }
+
+    // And restore any Structure which had been replaced in the type_info
+    // index by one that was just unregistered
+    if (typeinfoReplacedG) {
+        ContextList *pList = pContextListG;
+        for (u32 i = 0; pList && (i < pList->count); i++) {
+            Context *pContext = pList->pContexts[i];
+            if (pContext->GetType() == Context::Type_Namespace) {
+                continue;
+            }
+            const std::type_info *pTypeInfo = 
+                ((Structure *) pContext)->GetTypeInfo();
+            if (!pTypeInfo) {
+                continue;
+            }
+            const char *pName = pTypeInfo->name();
+            u32 hash = CompiledContextSet::Hash(pName);
+            if (!index_find(&pStructuresByTypeinfoG, hash, pName)) {
+                index_insert(&pStructuresByTypeinfoG, hash, pName, 
+                             pContext, 0);
+            }
+        }
+    }
+
+    hierarchy_invalidate();
+}
+
+
+static const Structure *lookup_structure(const std::type_info &typeinfo)
+{
+    ReadSection readSection;
+
+    index_pending();
+
+    Structure **ppCached = typeinfo_cache_slot(&typeinfo);
+
+    Structure *pStructure = __atomic_load_n(ppCached, __ATOMIC_ACQUIRE);
+
+    if (pStructure && (pStructure->GetTypeInfo() == &typeinfo)) {
+        return pStructure;
+    }
+
+    const char *pName = typeinfo.name();
+
+    pStructure = (Structure *) 
+        index_lookup(&pStructuresByTypeinfoG, 
+                     CompiledContextSet::Hash(pName), pName);
+
+    // Only cache it if this is the type_info that the Structure was
+    // registered with, otherwise it could never hit
+    if (pStructure && (pStructure->GetTypeInfo() == &typeinfo)) {
+        __atomic_store_n(ppCached, pStructure, __ATOMIC_RELEASE);
+    }
+
+    return pStructure;
+}
+
+
+// **************************************************************************
+// Registration sections
+// **************************************************************************
+
+// Registered with __cxa_atexit() against the object whose bounds pArg
+// are, so that it runs when that object is unloaded (or the process
+// exits), before the object's own static objects are destroyed.  All of
+// the object's registrations are unregistered at once, waiting for a
+// single grace period, rather than one at a time.
+static void unregister_registrations(void *pArg)
+{
+    CompiledRegistration **pBounds = (CompiledRegistration **) pArg;
+
+    vector<Context *> vContexts;
+    vector<u32> vHashes;
+    vector<Type *> vTypes;
+    vector<u32> vTypeFingerprints;
+
+    pthread_mutex_lock(&registryMutexG);
+
+    for (CompiledRegistration *pRegistration = pBounds[0];
+         pRegistration < pBounds[1]; pRegistration++) {
+        if (!pRegistration->registered) {
+            continue;
+        }
+        for (u32 i = 0; i < pRegistration->contextCount; i++) {
+            vContexts.push_back(pRegistration->pContexts[i]);
+            vHashes.push_back(pRegistration->pHashes ? 
+                              pRegistration->pHashes[i] :
+                              CompiledContextSet::Hash
+                              (pRegistration->pContexts[i]->GetFullName()));
+        }
+        vTypes.insert(vTypes.end(), pRegistration->pTypes,
+                      pRegistration->pTypes + pRegistration->typeCount);
+        vTypeFingerprints.insert
+            (vTypeFingerprints.end(), pRegistration->pTypeFingerprints,
+             pRegistration->pTypeFingerprints + 
+             (4 * pRegistration->typeCount));
+        pRegistration->registered = 0;
+    }
+
+    if (!vTypes.empty()) {
+        unregister_types(vTypes.size(), &(vTypes[0]), 
+                         &(vTypeFingerprints[0]));
+    }
+
+    if (!vContexts.empty()) {
+        unregister_contexts(vContexts.size(), &(vContexts[0]), 
+                            &(vHashes[0]));
+    }
+
+    reclaim();
+
+    pthread_mutex_unlock(&registryMutexG);
+}
+
+
+static int get_load_count(struct dl_phdr_info *pInfo, size_t /* size */,
+                          void *pLoadCount)
+{
+    *((u32 *) pLoadCount) = (u32) pInfo->dlpi_adds;
+
+    // Only the first object needs to be visited
+    return 1;
+}
+
+
+static int get_object_name(struct dl_phdr_info *pInfo, size_t /* size */,
+                           void *pNames)
+{
+    ((vector<string> *) pNames)->push_back
+        (pInfo->dlpi_name ? pInfo->dlpi_name : "");
+
+    return 0;
+}
+
+
+// Registers every CompiledRegistration which code generated by xrttigen -s
+// has placed in the XRTTI_REGISTRY_SECTION of any loaded object, and which
+// is not registered yet.  The objects are only searched if any have been
+// loaded since the last search.  Returns true if anything was registered.
+//
+// This is called on the first use of the registry, on a lookup which
+// misses, and by RefreshContexts(); never on a hit, since even finding out
+// whether anything has been loaded takes the dynamic linker's lock.
+//
+// Must not be called with registryMutexG held, or from within a read
+// section.  The dynamic linker is never called with registryMutexG held,
+// since a library being loaded may register contexts from a static
+// constructor, while the dynamic linker holds its own lock.
+static bool register_sections()
+{
+    u32 loadCount = 0;
+    dl_iterate_phdr(&get_load_count, &loadCount);
+
+    if (__atomic_load_n(&searchedLoadCountG, __ATOMIC_ACQUIRE) == loadCount) {
+        return false;
+    }
+
+    vector<string> vNames;
+    dl_iterate_phdr(&get_object_name, &vNames);
+
+    // Each object that contains generated registrations defines its own
+    // bounds symbol, which dlsym() finds first when given that object's
+    // handle.  The handles are held until the registrations are registered
+    // so that none of the objects can be unloaded in the meantime.
+    vector<void *> vHandles;
+    vector<CompiledRegistration **> vBounds;
+    if (xrtti_registry_bounds) {
+        vBounds.push_back(xrtti_registry_bounds);
+    }
+    for (u32 i = 0; i < vNames.size(); i++) {
+        void *pHandle = dlopen(vNames[i].empty() ? 0 : vNames[i].c_str(),
+                               RTLD_LAZY | RTLD_NOLOAD);
+        if (!pHandle) {
+            continue;
+        }
+        vHandles.push_back(pHandle);
+        void *pBounds = dlsym(pHandle, XRTTI_REGISTRY_BOUNDS_SYMBOL);
+        if (pBounds) {
+            vBounds.push_back((CompiledRegistration **) pBounds);
+        }
+    }
+
+    bool registeredAny = false;
+
+    pthread_mutex_lock(&registryMutexG);
+
+    for (u32 i = 0; i < vBounds.size(); i++) {
+        bool registered = false;
+        for (CompiledRegistration *pRegistration = vBounds[i][0];
+             pRegistration < vBounds[i][1]; pRegistration++) {
+            // An object's bounds may be found more than once, when it is
+            // a dependency of an object which has none of its own
+            if (pRegistration->registered) {
+                continue;
+            }
+            register_contexts(pRegistration->contextCount,
+                              pRegistration->pContexts,
+                              pRegistration->pHashes,
+                              pRegistration->pFingerprints);
+            register_types(pRegistration->typeCount, pRegistration->pTypes,
+                           pRegistration->pTypeFingerprints);
+            pRegistration->registered = 1;
+            registered = true;
+        }
+        // Every registration within one object's bounds is in that object
+        if (registered) {
+            abi::__cxa_atexit(&unregister_registrations, vBounds[i],
+                              vBounds[i][0]->pDsoHandle);
+            registeredAny = true;
+        }
+    }
+
+    __atomic_store_n(&searchedLoadCountG, loadCount, __ATOMIC_RELEASE);
+
+    // Also free what registration from static constructors has left, since
+    // unlike them, this is not running while the dynamic linker holds its
+    // lock
+    if (has_retired()) {
+        reclaim();
+    }
+
+    pthread_mutex_unlock(&registryMutexG);
+
+    for (u32 i = 0; i < vHandles.size(); i++) {
+        dlclose(vHandles[i]);
+    }
+
+    return registeredAny;
+}
+
+
+// Nothing is registered from registration sections until the first time
+// that the registry is used
+static inline void register_sections_once()
+{
+    if (!__atomic_load_n(&searchedLoadCountG, __ATOMIC_ACQUIRE)) {
+        (void) register_sections();
+    }
+}
+
+
+// **************************************************************************
+// CompiledContextSet implementation
+// **************************************************************************
 
 /* static */
 u32 CompiledContextSet::GetContextCount()
 {
-    return vContextsG.size();
+    register_sections_once();
+
+    ReadSection readSection;
+
+    index_pending();
+
+    ContextList *pList = __atomic_load_n(&pContextListG, __ATOMIC_ACQUIRE);
+
+    return pList ? __atomic_load_n(&(pList->count), __ATOMIC_ACQUIRE) : 0;
 }
 
     
 /* static */
 const Context *CompiledContextSet::GetContext(u32 index)
 {
-    return vContextsG[index];
+    register_sections_once();
+
+    ReadSection readSection;
+
+    index_pending();
+
+    ContextList *pList = __atomic_load_n(&pContextListG, __ATOMIC_ACQUIRE);
+
+    // Contexts may have been unregistered since the caller got the count
+    if (!pList || (index >= __atomic_load_n(&(pList->count), 
+                                            __ATOMIC_ACQUIRE))) {
+        return 0;
+    }
+
+    return pList->pContexts[index];
 }
 
     
 /* static */
 const Context *CompiledContextSet::LookupContext(const char *pFullName)
 {
-    map<string, Context *>::iterator iter =
-        htNonAnonymousContextsByNameG.find(pFullName);
-    
-    if (iter == htNonAnonymousContextsByNameG.end()) {
-        return 0;
-    }
-    
-    return iter->second;
+    register_sections_once();
+
+    u32 hash = Hash(pFullName);
+
+    do {
+        ReadSection readSection;
+
+        index_pending();
+
+        const Context *pContext = 
+            index_lookup(&pContextsByNameG, hash, pFullName);
+
+        if (pContext) {
+            return pContext;
+        }
+    } while (register_sections());
+
+    return 0;
 }
 
 
@@ -83,67 +2078,217 @@ const Context *CompiledContextSet::LookupContext(const char *pFullName)
 const Structure *
 CompiledContextSet::LookupStructure(const std::type_info &typeinfo)
 {
-    map<string, Structure *>::iterator iter =
-        htStructuresByTypeinfoG.find(typeinfo.name());
-    if (iter == htStructuresByTypeinfoG.end()) {
+    register_sections_once();
+
+    const Structure *pStructure;
+
+    do {
+        pStructure = lookup_structure(typeinfo);
+    } while (!pStructure && register_sections());
+
+    return pStructure;
+}
+
+
+/* static */
+bool CompiledContextSet::RefreshContexts()
+{
+    return register_sections();
+}
+
+
+/* static */
+bool CompiledContextSet::IsSubclassOf(const Structure &structure,
+                                      const Structure &base)
+{
+    register_sections_once();
+
+    ReadSection readSection;
+
+    index_pending();
+
+    const Hierarchy *pHierarchy = hierarchy_get();
+
+    u32 entry = hierarchy_find(pHierarchy, &structure);
+    u32 baseEntry = hierarchy_find(pHierarchy, &base);
+
+    return ((entry != HIERARCHY_NO_BIT) && 
+            (baseEntry != HIERARCHY_NO_BIT) &&
+            hierarchy_is_subclass(pHierarchy, entry, baseEntry));
+}
+
+
+/* static */
+u32 CompiledContextSet::GetDerivedCount(const Structure &structure)
+{
+    register_sections_once();
+
+    ReadSection readSection;
+
+    index_pending();
+
+    const Hierarchy *pHierarchy = hierarchy_get();
+
+    u32 entry = hierarchy_find(pHierarchy, &structure);
+
+    return ((entry == HIERARCHY_NO_BIT) ? 0 :
+            pHierarchy->pEntries[entry].derivedCount);
+}
+
+
+/* static */
+const Structure *CompiledContextSet::GetDerived(const Structure &structure,
+                                                u32 index)
+{
+    register_sections_once();
+
+    ReadSection readSection;
+
+    index_pending();
+
+    const Hierarchy *pHierarchy = hierarchy_get();
+
+    u32 entry = hierarchy_find(pHierarchy, &structure);
+
+    // Contexts may have been unregistered since the caller got the count
+    if ((entry == HIERARCHY_NO_BIT) || 
+        (index >= pHierarchy->pEntries[entry].derivedCount)) {
         return 0;
     }
 
-    return iter->second;
+    return pHierarchy->pEntries[entry].pDerived[index];
 }
 
 
 /* static */
-void CompiledContextSet::RegisterContext(Context *pContext)
+void *CompiledContextSet::Cast(void *pObject, const Structure &from,
+                               const Structure &to)
 {
-    Context *pExisting = 0;
+    if (!pObject || (&from == &to)) {
+        return pObject;
+    }
 
-    if ((pContext->GetType() == Context::Type_Namespace) ||
-        !((Structure *) pContext)->IsAnonymous()) {
-        map<string, Context *>::iterator iter =
-            htNonAnonymousContextsByNameG.find(pContext->GetFullName());
-        if (iter != htNonAnonymousContextsByNameG.end()) {
-            pExisting = iter->second;
-            switch (pContext->GetType()) {
-            case Context::Type_Class:
-                if (*((Class *) pContext) == *pExisting) {
-                    return;
-                }
-                break;
-            case Context::Type_Namespace:
-                if (*((Namespace *) pContext) == *pExisting) {
-                    return;
-                }
-                break;
-            case Context::Type_Struct:
-                if (*((Struct *) pContext) == *pExisting) {
-                    return;
-                }
-                break;
-            default: // Context::Type_Union
-                if (*((Union *) pContext) == *pExisting) {
-                    return;
-                }
-                break;
-            }
-            // This is bad - mismatch
-            fprintf(stderr, "Mismatched Contexts for %s\n", 
-                    pContext->GetFullName());
-            exit(-1);
-        }
-        
-        htNonAnonymousContextsByNameG[pContext->GetFullName()] = pContext;
+    register_sections_once();
+
+    ReadSection readSection;
+
+    index_pending();
+
+    const CastPath *pPath = cast_cache_lookup(&from, &to);
+    if (pPath) {
+        return cast_apply(pPath, pObject);
     }
-        
-    if (pContext->GetType() != Context::Type_Namespace) {
-        Structure *pStructure = (Structure *) pContext;
-        const std::type_info *pTypeInfo = pStructure->GetTypeInfo();
-        if (pTypeInfo) {
-            htStructuresByTypeinfoG[pTypeInfo->name()] = pStructure;
-        }
+
+    const Hierarchy *pHierarchy = hierarchy_get();
+
+    CastPath *pNewPath = cast_path_create(pHierarchy, pObject, from, to);
+    void *pResult = cast_apply(pNewPath, pObject);
+
+    // A Structure which is not registered may be destroyed at any time, and
+    // so nothing about it may be cached
+    if ((hierarchy_find(pHierarchy, &from) == HIERARCHY_NO_BIT) ||
+        (hierarchy_find(pHierarchy, &to) == HIERARCHY_NO_BIT) ||
+        !cast_cache_insert(pNewPath)) {
+        delete [] pNewPath->pSteps;
+        delete pNewPath;
     }
 
-    vContextsG.push_back(pContext);
+    return pResult;
+}
+
+
+/* static */
+void CompiledContextSet::RegisterContext(Context *pContext)
+{
+    RegisterContext(pContext, Hash(pContext->GetFullName()));
+}
+
+
+/* static */
+void CompiledContextSet::RegisterContext(Context *pContext, u32 hash)
+{
+    RegisterContexts(1, &pContext, &hash, 0);
+}
+
+
+/* static */
+void CompiledContextSet::RegisterContexts(u32 contextCount, 
+                                          Context **pContexts,
+                                          const u32 *pHashes,
+                                          const u32 *pFingerprints)
+{
+    // Anything that this retires is left for the next writer which waits
+    // for a grace period to free, since this may be running in a static
+    // constructor while the dynamic linker holds its lock
+    pthread_mutex_lock(&registryMutexG);
+
+    register_contexts(contextCount, pContexts, pHashes, pFingerprints);
+
+    pthread_mutex_unlock(&registryMutexG);
+}
+
+
+/* static */
+void CompiledContextSet::UnregisterContexts(u32 contextCount,
+                                            Context **pContexts,
+                                            const u32 *pHashes)
+{
+    pthread_mutex_lock(&registryMutexG);
+
+    unregister_contexts(contextCount, pContexts, pHashes);
+
+    // Nothing may return until no reader can still be using anything that
+    // was unregistered, because the caller may be about to unmap it
+    reclaim();
+
+    pthread_mutex_unlock(&registryMutexG);
+}
+
+
+/* static */
+void CompiledContextSet::Unregister(u32 contextCount, Context **pContexts,
+                                    const u32 *pHashes, u32 typeCount, 
+                                    Type **pTypes, 
+                                    const u32 *pTypeFingerprints)
+{
+    pthread_mutex_lock(&registryMutexG);
+
+    unregister_types(typeCount, pTypes, pTypeFingerprints);
+
+    unregister_contexts(contextCount, pContexts, pHashes);
+
+    reclaim();
+
+    pthread_mutex_unlock(&registryMutexG);
+}
+
+
+/* static */
+void CompiledContextSet::RegisterTypes(u32 typeCount, Type **pTypes,
+                                       const u32 *pFingerprints)
+{
+    pthread_mutex_lock(&registryMutexG);
+
+    register_types(typeCount, pTypes, pFingerprints);
+
+    pthread_mutex_unlock(&registryMutexG);
+}
+
+
+/* static */
+void CompiledContextSet::UnregisterTypes(u32 typeCount, Type **pTypes,
+                                         const u32 *pFingerprints)
+{
+    pthread_mutex_lock(&registryMutexG);
+
+    unregister_types(typeCount, pTypes, pFingerprints);
+
+    // As for Contexts, nothing may return until no reader can still be
+    // using a canonical Type which was just replaced, because the caller
+    // may be about to unmap it
+    reclaim();
+
+    pthread_mutex_unlock(&registryMutexG);
 }
 
 }; // namespace Xrtti
@@ -81,4 +81,26 @@ bool Enumeration::operator ==(const Enumeration &other) const
 }
 
 
+u32 Enumeration::DecomposeFlags(s32 value, const EnumerationValue **pFlags,
+                                s32 *pRemainder) const
+{
+    u32 bits = (u32) value, count = 0, flagCount = this->GetFlagCount();
+
+    for (u32 i = 0; i < flagCount; i++) {
+        const EnumerationValue &flag = this->GetFlag(i);
+        u32 bit = (u32) flag.GetValue();
+        if (bits & bit) {
+            pFlags[count++] = &flag;
+            bits &= ~bit;
+        }
+    }
+
+    if (pRemainder) {
+        *pRemainder = (s32) bits;
+    }
+
+    return count;
+}
+
+
 }; // namespace Xrtti
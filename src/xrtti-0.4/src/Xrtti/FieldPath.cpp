@@ -0,0 +1,205 @@
+/*****************************************************************************\
+ *                                                                           *
+ * FieldPath.cpp                                                             *
+ *                                                                           *
+ * ------------------------------------------------------------------------- *
+ * Copyright (C) 2007 Bryan Ischo <bryan@ischo.com>                          *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU General Public License Version 2 as published  *
+ * by the Free Software Foundation.                                          *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General *
+ * Public License for more details.                                          *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program; if not, write to:                                *
+ * The Free Software Foundation, Inc.                                        *
+ * 51 Franklin Street, Fifth Floor                                           *
+ * Boston, MA 02110-1301, USA.                                               *
+ * ------------------------------------------------------------------------- *
+ *                                                                           *
+\*****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "Xrtti/Xrtti.h"
+
+namespace Xrtti {
+
+#if 0 // This fixes indentation in emacs
+}
+#endif
+
+
+// Like Structure::LookupField(), but adds the offset of the Base that the
+// Field was found in to [offset], and finds nothing through a Base without
+// an offset
+static const Field *lookup_field(const Structure &structure,
+                                 const char *pName, u64 &offset)
+{
+    const Field *pField = structure.LookupDeclaredField(pName);
+
+    if (pField) {
+        return pField;
+    }
+
+    u32 count = structure.GetBaseCount();
+    for (u32 i = 0; i < count; i++) {
+        const Base &base = structure.GetBase(i);
+        u64 baseOffset = 0;
+        if (!(pField = lookup_field(base.GetStructure(), pName, baseOffset))) {
+            continue;
+        }
+        if (!base.HasOffset()) {
+            return 0;
+        }
+        offset += base.GetOffset() + baseOffset;
+        return pField;
+    }
+
+    return 0;
+}
+
+
+// Returns the Structure which a Type is, once its first [index] Arrays and
+// Pointers have been applied, or NULL if it is not a Structure
+static const Structure *type_structure(const Type &type, u32 index)
+{
+    if ((index < type.GetArrayOrPointerCount()) ||
+        (type.GetBaseType() != Type::BaseType_Structure)) {
+        return 0;
+    }
+
+    return &(((const TypeStructure &) type).GetStructure());
+}
+
+
+static bool is_pointer(const Type &type, u32 index)
+{
+    return ((index < type.GetArrayOrPointerCount()) &&
+            (type.GetArrayOrPointer(index).GetType() ==
+             ArrayOrPointer::Type_Pointer));
+}
+
+
+static bool is_name_char(char c, bool first)
+{
+    return (((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
+            (c == '_') || (!first && (c >= '0') && (c <= '9')));
+}
+
+
+FieldPath::FieldPath(const Structure &structure, const char *pPath)
+    : offsetCountM(0), pOffsetsM(0), pFieldM(0), indexCountM(0)
+{
+    // Offsets are accumulated as u64 so that overflow can be detected
+    std::vector<u64> offsets(1, 0);
+    const Structure *pStructure = &structure;
+    const Type *pType = 0;
+    const char *p = pPath;
+
+    while (true) {
+        // A Field name, of pStructure
+        const char *pName = p;
+        while (is_name_char(*p, (p == pName))) {
+            p++;
+        }
+        if (!pStructure || (p == pName)) {
+            return;
+        }
+        std::string name(pName, p - pName);
+        pFieldM = lookup_field(*pStructure, name.c_str(), offsets.back());
+        if (!pFieldM || !pFieldM->HasOffset()) {
+            return;
+        }
+        offsets.back() += pFieldM->GetOffset();
+        pType = &(pFieldM->GetType());
+        indexCountM = 0;
+
+        // A reference is held as a pointer to what it refers to
+        if (pType->IsReference()) {
+            offsets.push_back(0);
+        }
+
+        // Any number of indexes
+        while (*p == '[') {
+            if ((p[1] < '0') || (p[1] > '9')) {
+                return;
+            }
+            char *pEnd;
+            u64 index = strtoull(p + 1, &pEnd, 10);
+            if ((*pEnd != ']') ||
+                (indexCountM == pType->GetArrayOrPointerCount())) {
+                return;
+            }
+            u64 size = 
+                pType->GetArrayOrPointer(indexCountM).GetElementStride();
+            if (!size || (index > (0xFFFFFFFFULL / size))) {
+                return;
+            }
+            if (is_pointer(*pType, indexCountM)) {
+                offsets.push_back(0);
+            }
+            else if (index >= ((const Array &) pType->GetArrayOrPointer
+                               (indexCountM)).GetElementCount()) {
+                return;
+            }
+            offsets.back() += index * size;
+            if (offsets.back() > 0xFFFFFFFFULL) {
+                return;
+            }
+            indexCountM++;
+            p = pEnd + 1;
+        }
+
+        // The end, or a Field of the Structure (or pointer to Structure)
+        // reached so far
+        if (!*p) {
+            break;
+        }
+        if (!strncmp(p, "->", 2)) {
+            if (!is_pointer(*pType, indexCountM)) {
+                return;
+            }
+            p += 2;
+        }
+        else if (*p == '.') {
+            p++;
+        }
+        else {
+            return;
+        }
+        u32 index = indexCountM;
+        if (is_pointer(*pType, index)) {
+            offsets.push_back(0);
+            index++;
+        }
+        pStructure = type_structure(*pType, index);
+    }
+
+    for (u32 i = 0; i < offsets.size(); i++) {
+        if (offsets[i] > 0xFFFFFFFFULL) {
+            return;
+        }
+    }
+
+    pOffsetsM = new u32[offsets.size()];
+    for (u32 i = 0; i < offsets.size(); i++) {
+        pOffsetsM[i] = (u32) offsets[i];
+    }
+    offsetCountM = offsets.size();
+}
+
+
+FieldPath::~FieldPath()
+{
+    delete [] pOffsetsM;
+}
+
+
+}; // namespace Xrtti
@@ -23,6 +23,7 @@
  *                                                                           *
 \*****************************************************************************/
 
+#include <string.h>
 #include <private/StringUtils.h>
 #include <private/Parsed.h>
 
@@ -37,6 +38,7 @@ namespace Xrtti {
 
 
 ParsedEnumeration::ParsedEnumeration()
+    : isFlagsM(false)
 {
 }
 
@@ -106,10 +108,69 @@ bool ParsedEnumeration::Initialize(ParsedContextSet &set, Parser &parser,
         }
     }
 
+    this->FindFlags();
+
     return true;
 }
 
 
+void ParsedEnumeration::FindFlags()
+{
+    u32 count = valuesM.size();
+
+    // The first value declared with each bit set
+    for (u32 bit = 0; bit < 32; bit++) {
+        for (u32 i = 0; i < count; i++) {
+            if ((u32) valuesM[i].GetValue() == (1UL << bit)) {
+                flagsM.push_back(i);
+                break;
+            }
+        }
+    }
+
+    u32 flagBits = 0;
+    for (u32 i = 0; i < flagsM.size(); i++) {
+        flagBits |= (u32) valuesM[flagsM[i]].GetValue();
+    }
+
+    isFlagsM = !flagsM.empty();
+    for (u32 i = 0; i < count; i++) {
+        if ((u32) valuesM[i].GetValue() & ~flagBits) {
+            isFlagsM = false;
+        }
+    }
+}
+
+
+const char *ParsedEnumeration::LookupName(s32 value) const
+{
+    u32 count = valuesM.size();
+
+    for (u32 i = 0; i < count; i++) {
+        if (valuesM[i].GetValue() == value) {
+            return valuesM[i].GetName();
+        }
+    }
+
+    return 0;
+}
+
+
+bool ParsedEnumeration::LookupValue(const char *pName, s32 *pValue) const
+{
+    u32 count = valuesM.size();
+
+    for (u32 i = 0; i < count; i++) {
+        if (!strcmp(valuesM[i].GetName(), pName)) {
+            *pValue = valuesM[i].GetValue();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
 void ParsedEnumeration::MergeContents(ParsedContextSet &to,
                                       ParsedContextSet &from)
 {
@@ -23,6 +23,8 @@
  *                                                                           *
 \*****************************************************************************/
 
+#include <algorithm>
+#include <string.h>
 #include <private/Parsed.h>
 
 
@@ -35,6 +37,12 @@ namespace Xrtti {
 #endif
 
 
+static bool method_name_less(const Method *pA, const Method *pB)
+{
+    return (strcmp(pA->GetName(), pB->GetName()) < 0);
+}
+
+
 ParsedStruct::ParsedStruct()
 {
 }
@@ -120,6 +128,14 @@ bool ParsedStruct::Initialize(ParsedContextSet &set, Parser &parser,
         }
     }
 
+    // Overloads end up adjacent, in declaration order
+    vMethodsByNameM.resize(methodCount);
+    for (u32 i = 0; i < methodCount; i++) {
+        vMethodsByNameM[i] = &(vMethodsM[i]);
+    }
+    stable_sort(vMethodsByNameM.begin(), vMethodsByNameM.end(), 
+                &method_name_less);
+
     return true;
 }
 
@@ -152,4 +168,51 @@ const Method &ParsedStruct::GetMethod(u32 index) const
 }
 
 
+MethodOverloads ParsedStruct::LookupDeclaredMethods(const char *pName) const
+{
+    u32 count = vMethodsByNameM.size();
+    for (u32 i = 0; i < count; i++) {
+        if (strcmp(vMethodsByNameM[i]->GetName(), pName)) {
+            continue;
+        }
+        u32 last = i + 1;
+        while ((last < count) && 
+               !strcmp(vMethodsByNameM[last]->GetName(), pName)) {
+            last++;
+        }
+        return MethodOverloads(last - i, &(vMethodsByNameM[i]));
+    }
+
+    return MethodOverloads();
+}
+
+
+const Method *ParsedStruct::LookupDeclaredMethod
+    (const char *pName, u32 argumentCount, 
+     const Xrtti::Type * const *pArgumentTypes) const
+{
+    MethodOverloads overloads = this->LookupDeclaredMethods(pName);
+
+    u32 count = overloads.GetMethodCount();
+    for (u32 i = 0; i < count; i++) {
+        const MethodSignature &signature = 
+            overloads.GetMethod(i).GetSignature();
+        if (signature.GetArgumentCount() != argumentCount) {
+            continue;
+        }
+        u32 j = 0;
+        while ((j < argumentCount) && 
+               Equals(signature.GetArgument(j).GetType(), 
+                      *(pArgumentTypes[j]))) {
+            j++;
+        }
+        if (j == argumentCount) {
+            return &(overloads.GetMethod(i));
+        }
+    }
+
+    return 0;
+}
+
+
 }; // namespace Xrtti
@@ -23,6 +23,7 @@
  *                                                                           *
 \*****************************************************************************/
 
+#include <string.h>
 #include <private/StringUtils.h>
 #include <private/Parsed.h>
 
@@ -335,6 +336,19 @@ const Field &ParsedStructure::GetField(u32 index) const
 }
 
 
+const Field *ParsedStructure::LookupDeclaredField(const char *pName) const
+{
+    u32 count = vFieldsM.size();
+    for (u32 i = 0; i < count; i++) {
+        if (!strcmp(vFieldsM[i].GetName(), pName)) {
+            return &(vFieldsM[i]);
+        }
+    }
+
+    return 0;
+}
+
+
 const Constructor &ParsedStructure::GetConstructor(u32 index) const
 {
     return vConstructorsM[index];
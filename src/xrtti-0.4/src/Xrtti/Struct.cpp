@@ -108,4 +108,122 @@ bool Struct::operator ==(const Struct &other) const
 }
 
 
+// Finds the Methods named pName in structRef or its bases, casting
+// *pInstance along the way to the Struct declaring them.  Sets ambiguous if
+// Methods of that name are found in two different base Structs.
+static MethodOverloads FindMethods(const Struct &structRef, const char *pName,
+                                   void **ppInstance, bool &ambiguous)
+{
+    MethodOverloads overloads = structRef.LookupDeclaredMethods(pName);
+
+    if (overloads.GetMethodCount()) {
+        return overloads;
+    }
+
+    MethodOverloads found;
+    void *pFoundInstance = 0;
+
+    u32 count = structRef.GetBaseCount();
+    for (u32 i = 0; i < count; i++) {
+        const Base &base = structRef.GetBase(i);
+
+        // Unions have no Methods
+        Context::Type type = base.GetStructure().GetType();
+        if ((type != Context::Type_Struct) && (type != Context::Type_Class)) {
+            continue;
+        }
+
+        void *pBaseInstance = (*ppInstance && base.IsCastable()) ?
+            base.CastSubclass(*ppInstance) : 0;
+
+        overloads = FindMethods((const Struct &) base.GetStructure(), pName,
+                                &pBaseInstance, ambiguous);
+
+        if (ambiguous) {
+            return MethodOverloads();
+        }
+
+        if (!overloads.GetMethodCount()) {
+            continue;
+        }
+
+        if (found.GetMethodCount()) {
+            // The same Struct reached through more than one Base
+            if (&(found.GetMethod(0).GetContext()) == 
+                &(overloads.GetMethod(0).GetContext())) {
+                continue;
+            }
+            ambiguous = true;
+            return MethodOverloads();
+        }
+
+        found = overloads;
+        pFoundInstance = pBaseInstance;
+    }
+
+    if (found.GetMethodCount()) {
+        *ppInstance = pFoundInstance;
+    }
+
+    return found;
+}
+
+
+MethodOverloads Struct::LookupMethods(const char *pName, void **ppInstance)
+    const
+{
+    void *pInstance = ppInstance ? *ppInstance : 0;
+    bool ambiguous = false;
+
+    MethodOverloads overloads = FindMethods(*this, pName, &pInstance,
+                                            ambiguous);
+
+    if (overloads.GetMethodCount() && ppInstance) {
+        *ppInstance = pInstance;
+    }
+
+    return overloads;
+}
+
+
+const Method *Struct::LookupMethod(const char *pName, u32 argumentCount,
+                                   const Xrtti::Type * const *pArgumentTypes,
+                                   void **ppInstance) const
+{
+    const Method *pMethod = this->LookupDeclaredMethod
+        (pName, argumentCount, pArgumentTypes);
+
+    if (pMethod) {
+        return pMethod;
+    }
+
+    // Find the Struct whose Methods of this name are not hidden, and
+    // resolve the call among those
+    void *pInstance = ppInstance ? *ppInstance : 0;
+
+    MethodOverloads overloads = 
+        this->LookupMethods(pName, ppInstance ? &pInstance : 0);
+
+    if (!overloads.GetMethodCount()) {
+        return 0;
+    }
+
+    const Struct &structRef = 
+        (const Struct &) overloads.GetMethod(0).GetContext();
+
+    if (&structRef == this) {
+        return 0;
+    }
+
+    pMethod = structRef.LookupDeclaredMethod
+        (pName, argumentCount, pArgumentTypes);
+
+    if (pMethod && ppInstance) {
+        *ppInstance = pInstance;
+    }
+
+    return pMethod;
+}
+
+
 }; // namespace Xrtti
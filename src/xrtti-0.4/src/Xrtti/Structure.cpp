@@ -118,4 +118,120 @@ bool Structure::operator ==(const Structure &other) const
 }
 
 
+// Finds the Field named pName in structure or its bases, casting *pInstance
+// along the way to the Structure declaring it.  Sets ambiguous if two
+// different Fields of that name are found in different bases.
+static const Field *FindField(const Structure &structure, const char *pName,
+                              void **ppInstance, bool &ambiguous)
+{
+    const Field *pField = structure.LookupDeclaredField(pName);
+
+    if (pField) {
+        return pField;
+    }
+
+    const Field *pFound = 0;
+    void *pFoundInstance = 0;
+
+    u32 count = structure.GetBaseCount();
+    for (u32 i = 0; i < count; i++) {
+        const Base &base = structure.GetBase(i);
+
+        void *pBaseInstance = (*ppInstance && base.IsCastable()) ?
+            base.CastSubclass(*ppInstance) : 0;
+
+        pField = FindField(base.GetStructure(), pName, &pBaseInstance,
+                           ambiguous);
+
+        if (ambiguous) {
+            return 0;
+        }
+
+        if (!pField || (pField == pFound)) {
+            continue;
+        }
+
+        if (pFound) {
+            ambiguous = true;
+            return 0;
+        }
+
+        pFound = pField;
+        pFoundInstance = pBaseInstance;
+    }
+
+    if (pFound) {
+        *ppInstance = pFoundInstance;
+    }
+
+    return pFound;
+}
+
+
+const Field *Structure::LookupField(const char *pName, void **ppInstance) 
+    const
+{
+    void *pInstance = ppInstance ? *ppInstance : 0;
+    bool ambiguous = false;
+
+    const Field *pField = FindField(*this, pName, &pInstance, ambiguous);
+
+    if (pField && ppInstance) {
+        *ppInstance = pInstance;
+    }
+
+    return pField;
+}
+
+
+void *Structure::Create(Allocator &allocator) const
+{
+    void *pMemory = allocator.Allocate(this->GetSizeof(), this->GetAlignof());
+
+    return pMemory ? this->ConstructAt(pMemory) : 0;
+}
+
+
+void *Structure::CreateArray(u32 count, Allocator &allocator) const
+{
+    u32 size = this->GetSizeof();
+    if (size && (count > (((u32) -1) / size))) {
+        return 0;
+    }
+
+    char *pMemory = (char *) allocator.Allocate
+        (count * size, this->GetAlignof());
+    if (pMemory) {
+        for (u32 i = 0; i < count; i++) {
+            this->ConstructAt(pMemory + (i * size));
+        }
+    }
+
+    return pMemory;
+}
+
+
+void Structure::Delete(void *pInstance, Allocator &allocator) const
+{
+    if (pInstance) {
+        this->DestroyAt(pInstance);
+        allocator.Free(pInstance, this->GetSizeof());
+    }
+}
+
+
+void Structure::DeleteArray(void *pInstanceArray, u32 count, 
+                            Allocator &allocator) const
+{
+    if (pInstanceArray) {
+        // Destroyed in the reverse order of construction, as delete [] does
+        u32 size = this->GetSizeof();
+        for (u32 i = count; i--; ) {
+            this->DestroyAt(((char *) pInstanceArray) + (i * size));
+        }
+        allocator.Free(pInstanceArray, count * size);
+    }
+}
+
+
 }; // namespace Xrtti
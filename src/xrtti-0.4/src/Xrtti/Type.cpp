@@ -34,6 +34,10 @@ namespace Xrtti {
 
 bool Type::operator ==(const Type &other) const
 {
+    if (&(this->GetCanonical()) == &(other.GetCanonical())) {
+        return true;
+    }
+
     if (this->GetBaseType() != other.GetBaseType()) {
         return false;
     }
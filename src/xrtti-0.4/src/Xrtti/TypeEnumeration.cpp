@@ -34,6 +34,10 @@ namespace Xrtti {
 
 bool TypeEnumeration::operator ==(const TypeEnumeration &other) const
 {
+    if (&(this->GetCanonical()) == &(other.GetCanonical())) {
+        return true;
+    }
+
     if (!((const Type *) this)->Type::operator ==((const Type &) other)) {
         return false;
     }
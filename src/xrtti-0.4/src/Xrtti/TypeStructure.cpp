@@ -36,6 +36,10 @@ namespace Xrtti {
 
 bool TypeStructure::operator ==(const TypeStructure &other) const
 {
+    if (&(this->GetCanonical()) == &(other.GetCanonical())) {
+        return true;
+    }
+
     if (!((const Type *) this)->Type::operator ==((const Type &) other)) {
         return false;
     }
@@ -54,6 +54,11 @@ bool Equals(const Context &c1, const Context &c2)
 
 bool Equals(const Type &type1, const Type &type2)
 {
+    // Interned Types which are equal share their canonical Type
+    if (&(type1.GetCanonical()) == &(type2.GetCanonical())) {
+        return true;
+    }
+
     Type::BaseType t1 = type1.GetBaseType();
     if (t1 != type2.GetBaseType()) {
         return false;
@@ -99,4 +104,34 @@ const Structure *LookupStructure(const std::type_info &typeinfo)
 }
 
 
+bool RefreshContexts()
+{
+    return CompiledContextSet::RefreshContexts();
+}
+
+
+bool IsSubclassOf(const Structure &structure, const Structure &base)
+{
+    return CompiledContextSet::IsSubclassOf(structure, base);
+}
+
+
+u32 GetDerivedCount(const Structure &structure)
+{
+    return CompiledContextSet::GetDerivedCount(structure);
+}
+
+
+const Structure *GetDerived(const Structure &structure, u32 index)
+{
+    return CompiledContextSet::GetDerived(structure, index);
+}
+
+
+void *Cast(void *pObject, const Structure &from, const Structure &to)
+{
+    return CompiledContextSet::Cast(pObject, from, to);
+}
+
+
 }; // namespace Xrtti
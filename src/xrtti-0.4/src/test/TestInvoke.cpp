@@ -0,0 +1,330 @@
+/*****************************************************************************\
+ *                                                                           *
+ * TestInvoke.cpp                                                            *
+ *                                                                           *
+ * ------------------------------------------------------------------------- *
+ * Copyright (C) 2007 Bryan Ischo <bryan@ischo.com>                          *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU General Public License Version 2 as published  *
+ * by the Free Software Foundation.                                          *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General *
+ * Public License for more details.                                          *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program; if not, write to:                                *
+ * The Free Software Foundation, Inc.                                        *
+ * 51 Franklin Street, Fifth Floor                                           *
+ * Boston, MA 02110-1301, USA.                                               *
+ * ------------------------------------------------------------------------- *
+ *                                                                           *
+ * This test checks that the thunks exported by Method, Field and            *
+ * Constructor behave just as the virtual methods which call them, and then  *
+ * benchmarks calling TestMethods::Sum and getting                           *
+ * TestMethodsSecond::secondM directly, through the thunks, and through the  *
+ * virtual methods.  It then benchmarks calling TestMethods::Sum on each of  *
+ * an array of instances directly, through Method::Invoke, and through       *
+ * Method::InvokeBatch, creating and deleting TestMethodsSecond instances   *
+ * with global new, an ArenaAllocator and a PoolAllocator, walking the      *
+ * fields of TestMethods::Inner through Field and through FieldLayout, and   *
+ * reaching TestMethods::innerM.b by name lookups and through a FieldPath.   *
+ *                                                                           *
+\*****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <Xrtti/Xrtti.h>
+#include <test/TestMethods.h>
+
+using namespace Xrtti;
+
+#define ITERATIONS 10000000
+#define BATCH_SIZE 1000
+
+
+static double now()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (ts.tv_sec * 1000000000.0) + ts.tv_nsec;
+}
+
+
+static void report(const char *pName, double start)
+{
+    printf("%-32s %8.2f ns/call\n", pName, (now() - start) / ITERATIONS);
+}
+
+
+int main(int /* argc */, char ** /* argv */)
+{
+    const Class *pClass = (const Class *) LookupContext("TestMethods");
+    if (!pClass) {
+        fprintf(stderr, "Failed to lookup TestMethods\n");
+        exit(-1);
+    }
+
+    MethodOverloads overloads = pClass->LookupMethods("Sum");
+    const Method *pSum = 
+        (overloads.GetMethodCount() == 1) ? &(overloads.GetMethod(0)) : 0;
+    const Class *pSecond = 
+        (const Class *) LookupContext("TestMethodsSecond");
+    const Field *pSecondField = 
+        pSecond ? pSecond->LookupDeclaredField("secondM") : 0;
+    if (!pSum || !pSecondField) {
+        fprintf(stderr, "Failed to lookup TestMethods members\n");
+        exit(-1);
+    }
+
+    Method::InvokeThunk pSumThunk = pSum->GetInvokeThunk();
+    Field::GetThunk pSecondThunk = pSecondField->GetGetThunk();
+    BoundMethod<s32 (s32, s32)> sum = pSum->Bind<s32 (s32, s32)>();
+    if (!pSumThunk || !pSecondThunk || !sum.IsBound()) {
+        fprintf(stderr, "Missing TestMethods thunks\n");
+        exit(-1);
+    }
+
+    // The default constructor is the only one without arguments
+    Constructor::InvokeThunk pCreateThunk = 0;
+    for (::u32 i = 0; i < pClass->GetConstructorCount(); i++) {
+        const Constructor &constructor = pClass->GetConstructor(i);
+        if (!constructor.GetSignature().GetArgumentCount()) {
+            pCreateThunk = constructor.GetInvokeThunk();
+        }
+    }
+    if (!pCreateThunk) {
+        fprintf(stderr, "Missing TestMethods constructor thunk\n");
+        exit(-1);
+    }
+
+    TestMethods *pInstance = (TestMethods *) (*pCreateThunk)(0);
+    TestMethodsSecond *pSecondInstance = pInstance;
+
+    s32 thunkResult, invokeResult, arg1 = 3, arg2 = 4;
+    void *args[2] = { &arg1, &arg2 };
+    (*pSumThunk)(pInstance, &thunkResult, args);
+    pSum->Invoke(pInstance, &invokeResult, args);
+    if ((thunkResult != 7) || (invokeResult != 7) ||
+        ((*pSecondThunk)(pSecondInstance) != 
+         pSecondField->Get(pSecondInstance))) {
+        fprintf(stderr, "TestMethods thunks disagree with Invoke and Get\n");
+        exit(-1);
+    }
+
+    // Every loop sums the results so that the calls cannot be optimized
+    // away, and reads the instance through a volatile pointer so that the
+    // direct calls cannot be hoisted out of the loop
+    TestMethods * volatile pVolatile = pInstance;
+    TestMethodsSecond * volatile pSecondVolatile = pSecondInstance;
+    long total = 0;
+
+    double start = now();
+    for (s32 i = 0; i < ITERATIONS; i++) {
+        total += pVolatile->Sum(i, 1);
+    }
+    report("direct Sum", start);
+
+    start = now();
+    for (s32 i = 0; i < ITERATIONS; i++) {
+        total += sum(pVolatile, i, 1);
+    }
+    report("BoundMethod Sum", start);
+
+    start = now();
+    for (s32 i = 0; i < ITERATIONS; i++) {
+        s32 result, one = 1;
+        void *sumArgs[2] = { &i, &one };
+        (*pSumThunk)(pVolatile, &result, sumArgs);
+        total += result;
+    }
+    report("GetInvokeThunk Sum", start);
+
+    start = now();
+    for (s32 i = 0; i < ITERATIONS; i++) {
+        s32 result, one = 1;
+        void *sumArgs[2] = { &i, &one };
+        pSum->Invoke(pVolatile, &result, sumArgs);
+        total += result;
+    }
+    report("Method::Invoke Sum", start);
+
+    start = now();
+    for (s32 i = 0; i < ITERATIONS; i++) {
+        total += pSecondVolatile->secondM;
+    }
+    report("direct secondM", start);
+
+    start = now();
+    for (s32 i = 0; i < ITERATIONS; i++) {
+        total += * (::u32 *) (*pSecondThunk)(pSecondVolatile);
+    }
+    report("GetGetThunk secondM", start);
+
+    start = now();
+    for (s32 i = 0; i < ITERATIONS; i++) {
+        total += * (::u32 *) pSecondField->Get(pSecondVolatile);
+    }
+    report("Field::Get secondM", start);
+
+    if (!pSum->IsBatchInvokeable()) {
+        fprintf(stderr, "TestMethods::Sum is not batch invokeable\n");
+        exit(-1);
+    }
+
+    TestMethods *pArray = new TestMethods[BATCH_SIZE];
+    TestMethods * volatile pArrayVolatile = pArray;
+    s32 *pArg1 = new s32[BATCH_SIZE], *pArg2 = new s32[BATCH_SIZE];
+    s32 *pResults = new s32[BATCH_SIZE];
+    void *batchArgs[2] = { pArg1, pArg2 };
+    for (s32 i = 0; i < BATCH_SIZE; i++) {
+        pArg1[i] = i, pArg2[i] = 1;
+    }
+
+    pSum->InvokeBatch(pArray, BATCH_SIZE, sizeof(TestMethods), pResults,
+                      batchArgs);
+    for (s32 i = 0; i < BATCH_SIZE; i++) {
+        if (pResults[i] != (i + 1)) {
+            fprintf(stderr, "Method::InvokeBatch disagrees with Invoke\n");
+            exit(-1);
+        }
+    }
+
+    start = now();
+    for (s32 j = 0; j < (ITERATIONS / BATCH_SIZE); j++) {
+        TestMethods *pBatch = pArrayVolatile;
+        for (s32 i = 0; i < BATCH_SIZE; i++) {
+            pResults[i] = pBatch[i].Sum(pArg1[i], pArg2[i]);
+        }
+        total += pResults[j % BATCH_SIZE];
+    }
+    report("direct Sum array", start);
+
+    start = now();
+    for (s32 j = 0; j < (ITERATIONS / BATCH_SIZE); j++) {
+        TestMethods *pBatch = pArrayVolatile;
+        for (s32 i = 0; i < BATCH_SIZE; i++) {
+            void *sumArgs[2] = { &(pArg1[i]), &(pArg2[i]) };
+            pSum->Invoke(&(pBatch[i]), &(pResults[i]), sumArgs);
+        }
+        total += pResults[j % BATCH_SIZE];
+    }
+    report("Method::Invoke Sum array", start);
+
+    start = now();
+    for (s32 j = 0; j < (ITERATIONS / BATCH_SIZE); j++) {
+        pSum->InvokeBatch(pArrayVolatile, BATCH_SIZE, sizeof(TestMethods),
+                          pResults, batchArgs);
+        total += pResults[j % BATCH_SIZE];
+    }
+    report("Method::InvokeBatch Sum array", start);
+
+    // Each allocator creates BATCH_SIZE instances, then deletes them all
+    void **ppCreated = new void *[BATCH_SIZE];
+
+    start = now();
+    for (s32 j = 0; j < (ITERATIONS / BATCH_SIZE); j++) {
+        for (s32 i = 0; i < BATCH_SIZE; i++) {
+            ppCreated[i] = pSecond->Create();
+        }
+        for (s32 i = 0; i < BATCH_SIZE; i++) {
+            pSecond->Delete(ppCreated[i]);
+        }
+    }
+    report("Structure::Create new", start);
+
+    ArenaAllocator arena;
+    start = now();
+    for (s32 j = 0; j < (ITERATIONS / BATCH_SIZE); j++) {
+        for (s32 i = 0; i < BATCH_SIZE; i++) {
+            ppCreated[i] = pSecond->Create(arena);
+        }
+        // TestMethodsSecond needs no destruction, so the arena is just reset
+        arena.Reset();
+    }
+    report("Structure::Create arena", start);
+
+    PoolAllocator pool(*pSecond);
+    start = now();
+    for (s32 j = 0; j < (ITERATIONS / BATCH_SIZE); j++) {
+        for (s32 i = 0; i < BATCH_SIZE; i++) {
+            ppCreated[i] = pSecond->Create(pool);
+        }
+        for (s32 i = 0; i < BATCH_SIZE; i++) {
+            pSecond->Delete(ppCreated[i], pool);
+        }
+    }
+    report("Structure::Create pool", start);
+
+    // Each walk sums the unsigned int fields of TestMethods::Inner, as a
+    // generic dumper would find them
+    const Structure *pInner = 
+        (const Structure *) LookupContext("TestMethods::Inner");
+    if (!pInner || !pInner->GetFieldLayout()) {
+        fprintf(stderr, "Missing TestMethods::Inner field layout\n");
+        exit(-1);
+    }
+    TestMethods::Inner inner = { 1, 2.0 };
+    char * volatile pInnerVolatile = (char *) &inner;
+
+    start = now();
+    for (s32 i = 0; i < ITERATIONS; i++) {
+        for (::u32 j = 0; j < pInner->GetFieldCount(); j++) {
+            const Field &field = pInner->GetField(j);
+            Type::BaseType baseType = field.GetType().GetBaseType();
+            if (field.HasOffset() && 
+                (baseType == Type::BaseType_Unsigned_Int)) {
+                total += * (::u32 *) (pInnerVolatile + field.GetOffset());
+            }
+        }
+    }
+    report("Field walk Inner", start);
+
+    start = now();
+    for (s32 i = 0; i < ITERATIONS; i++) {
+        const FieldLayout *pLayout = pInner->GetFieldLayout();
+        for (::u32 j = 0; j < pInner->GetFieldCount(); j++) {
+            if ((pLayout[j].flags & FieldLayout::Flag_HasOffset) &&
+                (pLayout[j].baseType == Type::BaseType_Unsigned_Int)) {
+                total += * (::u32 *) (pInnerVolatile + pLayout[j].offset);
+            }
+        }
+    }
+    report("FieldLayout walk Inner", start);
+
+    FieldPath innerB(*pClass, "innerM.b");
+    if (!innerB.IsValid()) {
+        fprintf(stderr, "Failed to resolve TestMethods innerM.b\n");
+        exit(-1);
+    }
+
+    start = now();
+    for (s32 i = 0; i < ITERATIONS; i++) {
+        const Field *pInnerField = pClass->LookupField("innerM");
+        const Structure &innerStructure = 
+            ((const TypeStructure &) pInnerField->GetType()).GetStructure();
+        const Field *pB = innerStructure.LookupDeclaredField("b");
+        total += (long) * (float *) pB->Get(pInnerField->Get(pVolatile));
+    }
+    report("LookupField innerM.b", start);
+
+    start = now();
+    for (s32 i = 0; i < ITERATIONS; i++) {
+        total += (long) * (float *) innerB.Evaluate(pVolatile);
+    }
+    report("FieldPath innerM.b", start);
+
+    delete [] ppCreated;
+    delete [] pResults;
+    delete [] pArg2;
+    delete [] pArg1;
+    delete [] pArray;
+    delete pInstance;
+
+    return (total == 0);
+}
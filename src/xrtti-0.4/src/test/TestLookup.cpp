@@ -0,0 +1,442 @@
+/*****************************************************************************\
+ *                                                                           *
+ * TestLookup.cpp                                                            *
+ *                                                                           *
+ * ------------------------------------------------------------------------- *
+ * Copyright (C) 2007 Bryan Ischo <bryan@ischo.com>                          *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU General Public License Version 2 as published  *
+ * by the Free Software Foundation.                                          *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General *
+ * Public License for more details.                                          *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program; if not, write to:                                *
+ * The Free Software Foundation, Inc.                                        *
+ * 51 Franklin Street, Fifth Floor                                           *
+ * Boston, MA 02110-1301, USA.                                               *
+ * ------------------------------------------------------------------------- *
+ *                                                                           *
+ * This test checks that every registered Context can be looked up by name   *
+ * and by type_info, checks that lookups and subclass queries keep working   *
+ * while more Contexts are registered and unregistered from another thread,  *
+ * checks duplicate registration and the interning of Types, and then      *
+ * benchmarks LookupContext and LookupStructure against a std::map keyed the *
+ * same way.                                                                 *
+ *                                                                           *
+\*****************************************************************************/
+
+#include <map>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <time.h>
+#include <vector>
+#include <Xrtti/XrttiPrivate.h>
+#include <test/TestClasses.h>
+
+using namespace Xrtti;
+using namespace std;
+
+#define ITERATIONS 200
+#define REGISTER_COUNT 20000
+#define READER_COUNT 4
+
+static vector<const char *> vNamesG;
+static ::u32 staticCountG;
+static bool doneG;
+
+
+static double now()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (ts.tv_sec * 1000000000.0) + ts.tv_nsec;
+}
+
+
+static void report(const char *pName, double start, ::u32 lookups)
+{
+    printf("%-32s %8.2f ns/lookup\n", pName, 
+           lookups ? ((now() - start) / lookups) : 0.0);
+}
+
+
+// Looks up the statically registered Contexts until doneG is set
+static void *reader(void * /* pArg */)
+{
+    while (!__atomic_load_n(&doneG, __ATOMIC_ACQUIRE)) {
+        ::u32 count = vNamesG.size();
+        for (::u32 i = 0; i < count; i++) {
+            const Context *pContext = LookupContext(vNamesG[i]);
+            if (!pContext || strcmp(pContext->GetFullName(), vNamesG[i])) {
+                fprintf(stderr, "Concurrent lookup of %s failed\n", 
+                        vNamesG[i]);
+                exit(-1);
+            }
+        }
+        
+        // The statically registered Contexts come first, and stay in place
+        // while others are registered and unregistered after them.  The
+        // others may be destroyed as soon as GetContext() returns them, so
+        // they are not looked at.
+        for (::u32 i = 0; i < staticCountG; i++) {
+            const Context *pContext = GetContext(i);
+            if (!pContext || !pContext->GetFullName()) {
+                fprintf(stderr, "Concurrent GetContext(%lu) failed\n",
+                        (unsigned long) i);
+                exit(-1);
+            }
+            if (pContext->GetType() == Context::Type_Namespace) {
+                continue;
+            }
+            // The class hierarchy index is rebuilt as the registry changes
+            const Structure *pStructure = (const Structure *) pContext;
+            ::u32 baseCount = pStructure->GetBaseCount();
+            for (::u32 j = 0; j < baseCount; j++) {
+                if (!IsSubclassOf(*pStructure, 
+                                  pStructure->GetBase(j).GetStructure())) {
+                    fprintf(stderr, "Concurrent IsSubclassOf(%s) failed\n",
+                            pContext->GetFullName());
+                    exit(-1);
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+// Registers Namespaces before the registry is first read, so that they are
+// only pending, and unregisters one from the middle and the newest before
+// the first lookup indexes what is left
+static void test_pending_register()
+{
+    static const char *pNames[3] = 
+        { "TestLookupPending0", "TestLookupPending1", "TestLookupPending2" };
+
+    Context *pContexts[3];
+    ::u32 hashes[3];
+    CompiledRegister *pRegisters[3];
+
+    for (::u32 i = 0; i < 3; i++) {
+        pContexts[i] = new CompiledNamespace(pNames[i], pNames[i], 0);
+        hashes[i] = CompiledContextSet::Hash(pNames[i]);
+        pRegisters[i] = new CompiledRegister
+            (1, &(pContexts[i]), &(hashes[i]), 0, 0, 0, 0);
+    }
+
+    delete pRegisters[1];
+    delete pRegisters[2];
+
+    if ((LookupContext(pNames[0]) != pContexts[0]) ||
+        LookupContext(pNames[1]) || LookupContext(pNames[2])) {
+        fprintf(stderr, "Failed to lookup pending Namespaces\n");
+        exit(-1);
+    }
+
+    delete pRegisters[0];
+
+    if (LookupContext(pNames[0])) {
+        fprintf(stderr, "Looked up unregistered %s\n", pNames[0]);
+        exit(-1);
+    }
+
+    for (::u32 i = 0; i < 3; i++) {
+        delete pContexts[i];
+    }
+
+    printf("Unregistered pending Namespaces before the first lookup\n");
+}
+
+
+// Registers and then unregisters REGISTER_COUNT new Namespaces while
+// READER_COUNT threads are looking up the existing ones
+static void test_concurrent_register()
+{
+    pthread_t readers[READER_COUNT];
+
+    staticCountG = GetContextCount();
+
+    for (::u32 i = 0; i < READER_COUNT; i++) {
+        pthread_create(&(readers[i]), 0, &reader, 0);
+    }
+
+    char **pNames = new char * [REGISTER_COUNT];
+    Context **pContexts = new Context * [REGISTER_COUNT];
+    ::u32 *pHashes = new ::u32[REGISTER_COUNT];
+
+    for (::u32 i = 0; i < REGISTER_COUNT; i++) {
+        pNames[i] = new char[32];
+        snprintf(pNames[i], 32, "TestLookup%lu", (unsigned long) i);
+        pContexts[i] = new CompiledNamespace(pNames[i], pNames[i], 0);
+        pHashes[i] = CompiledContextSet::Hash(pNames[i]);
+    }
+
+    // Register them in small batches, as a series of loaded libraries would
+    vector<CompiledRegister *> vRegisters;
+    for (::u32 i = 0; i < REGISTER_COUNT; i += 100) {
+        vRegisters.push_back(new CompiledRegister
+                             (100, &(pContexts[i]), &(pHashes[i]), 0, 0, 0,
+                              0));
+    }
+
+    for (::u32 i = 0; i < REGISTER_COUNT; i++) {
+        if (LookupContext(pNames[i]) != pContexts[i]) {
+            fprintf(stderr, "Failed to lookup %s\n", pNames[i]);
+            exit(-1);
+        }
+    }
+
+    printf("Registered %lu Namespaces concurrently with lookups\n",
+           (unsigned long) REGISTER_COUNT);
+
+    // Once a CompiledRegister is gone, nothing may still be using its
+    // Contexts, so they can be destroyed right away.  Every other one is
+    // unregistered first, as libraries being unloaded would be, and then
+    // the rest in the reverse of the order they were registered in, as at
+    // exit.
+    ::u32 count = vRegisters.size();
+    vector< ::u32> vOrder;
+    for (::u32 i = 0; i < count; i += 2) {
+        vOrder.push_back(i);
+    }
+    for (::u32 i = count; i-- > 0; ) {
+        if (i % 2) {
+            vOrder.push_back(i);
+        }
+    }
+    for (::u32 k = 0; k < count; k++) {
+        ::u32 i = vOrder[k];
+        delete vRegisters[i];
+        for (::u32 j = i * 100; j < ((i + 1) * 100); j++) {
+            delete pContexts[j];
+            pContexts[j] = 0;
+        }
+    }
+
+    __atomic_store_n(&doneG, true, __ATOMIC_RELEASE);
+
+    for (::u32 i = 0; i < READER_COUNT; i++) {
+        pthread_join(readers[i], 0);
+    }
+
+    for (::u32 i = 0; i < REGISTER_COUNT; i++) {
+        if (LookupContext(pNames[i])) {
+            fprintf(stderr, "Looked up unregistered %s\n", pNames[i]);
+            exit(-1);
+        }
+        delete [] pNames[i];
+    }
+
+    delete [] pNames;
+    delete [] pContexts;
+    delete [] pHashes;
+
+    if (GetContextCount() != staticCountG) {
+        fprintf(stderr, "Unregistered Contexts are still listed\n");
+        exit(-1);
+    }
+
+    printf("Unregistered %lu Namespaces concurrently with lookups\n",
+           (unsigned long) REGISTER_COUNT);
+}
+
+
+// Registers the same Namespace from two CompiledRegisters with equal
+// fingerprints, as two libraries including the same header would, and
+// checks that the second takes over when the first is unregistered
+static void test_duplicate_register()
+{
+    static const ::u32 fingerprint[4] = { 1, 2, 3, 4 };
+
+    Context *pFirst = 
+        new CompiledNamespace("TestLookupDup", "TestLookupDup", 0);
+    Context *pSecond = 
+        new CompiledNamespace("TestLookupDup", "TestLookupDup", 0);
+    ::u32 hash = CompiledContextSet::Hash("TestLookupDup");
+
+    CompiledRegister *pFirstRegister =
+        new CompiledRegister(1, &pFirst, &hash, fingerprint, 0, 0, 0);
+    CompiledRegister *pSecondRegister =
+        new CompiledRegister(1, &pSecond, &hash, fingerprint, 0, 0, 0);
+
+    if (LookupContext("TestLookupDup") != pFirst) {
+        fprintf(stderr, "Duplicate registration replaced the original\n");
+        exit(-1);
+    }
+
+    delete pFirstRegister;
+
+    if (LookupContext("TestLookupDup") != pSecond) {
+        fprintf(stderr, "Duplicate was not registered in place of the "
+                "original\n");
+        exit(-1);
+    }
+
+    delete pSecondRegister;
+
+    if (LookupContext("TestLookupDup")) {
+        fprintf(stderr, "Looked up unregistered duplicate\n");
+        exit(-1);
+    }
+
+    delete pFirst;
+    delete pSecond;
+
+    printf("Registered and unregistered duplicate Namespaces\n");
+}
+
+
+// Registers equal Types from two CompiledRegisters, as two libraries
+// including the same header would, and checks that they share the first
+// one as their canonical Type until it is unregistered
+static void test_intern_types()
+{
+    static const ::u32 fingerprint[4] = { 5, 6, 7, 8 };
+
+    Type *pFirst = new CompiledType(Type::BaseType_Int, false, false, false,
+                                    sizeof(int), sizeof(int), 0, 0);
+    Type *pSecond = new CompiledType(Type::BaseType_Int, false, false, false,
+                                     sizeof(int), sizeof(int), 0, 0);
+
+    CompiledRegister *pFirstRegister =
+        new CompiledRegister(0, 0, 0, 0, 1, &pFirst, fingerprint);
+    CompiledRegister *pSecondRegister =
+        new CompiledRegister(0, 0, 0, 0, 1, &pSecond, fingerprint);
+
+    if ((&(pFirst->GetCanonical()) != pFirst) ||
+        (&(pSecond->GetCanonical()) != pFirst)) {
+        fprintf(stderr, "Equal Types do not share a canonical Type\n");
+        exit(-1);
+    }
+
+    delete pFirstRegister;
+
+    if (&(pSecond->GetCanonical()) != pSecond) {
+        fprintf(stderr, "Unregistered Type is still canonical\n");
+        exit(-1);
+    }
+
+    delete pSecondRegister;
+
+    delete pFirst;
+    delete pSecond;
+
+    printf("Interned and unregistered equal Types\n");
+}
+
+
+int main(int /* argc */, char ** /* argv */)
+{
+    vector<const char *> &vNames = vNamesG;
+    vector<const std::type_info *> vTypeInfos;
+    map<string, const Context *> htContextsByName;
+    map<string, const Structure *> htStructuresByTypeinfo;
+
+    test_pending_register();
+
+    ::u32 count = GetContextCount();
+
+    for (::u32 i = 0; i < count; i++) {
+        const Context *pContext = GetContext(i);
+
+        if ((pContext->GetType() != Context::Type_Namespace) &&
+            ((const Structure *) pContext)->IsAnonymous()) {
+            continue;
+        }
+
+        if (LookupContext(pContext->GetFullName()) != pContext) {
+            fprintf(stderr, "Failed to lookup %s\n", pContext->GetFullName());
+            exit(-1);
+        }
+
+        vNames.push_back(pContext->GetFullName());
+        htContextsByName[pContext->GetFullName()] = pContext;
+
+        if (pContext->GetType() == Context::Type_Namespace) {
+            continue;
+        }
+
+        const Structure *pStructure = (const Structure *) pContext;
+        const std::type_info *pTypeInfo = pStructure->GetTypeInfo();
+        if (pTypeInfo) {
+            if (LookupStructure(*pTypeInfo) != pStructure) {
+                fprintf(stderr, "Failed to lookup type_info of %s\n",
+                        pContext->GetFullName());
+                exit(-1);
+            }
+            vTypeInfos.push_back(pTypeInfo);
+            htStructuresByTypeinfo[pTypeInfo->name()] = pStructure;
+        }
+    }
+
+    if (LookupContext("No::Such::Context")) {
+        fprintf(stderr, "Looked up nonexistent Context\n");
+        exit(-1);
+    }
+
+    // Nothing has been loaded since the first use of the registry
+    if (RefreshContexts() || (GetContextCount() != count)) {
+        fprintf(stderr, "Refreshed Contexts with nothing newly loaded\n");
+        exit(-1);
+    }
+
+    printf("Looked up %lu names and %lu type_infos\n",
+           (unsigned long) vNames.size(), (unsigned long) vTypeInfos.size());
+
+    test_concurrent_register();
+
+    test_duplicate_register();
+
+    test_intern_types();
+
+    // Every loop sums the results so that the lookups cannot be optimized
+    // away
+    unsigned long sum = 0;
+    ::u32 nameCount = vNames.size(), typeInfoCount = vTypeInfos.size();
+
+    double start = now();
+    for (::u32 j = 0; j < ITERATIONS; j++) {
+        for (::u32 i = 0; i < nameCount; i++) {
+            sum += (unsigned long) LookupContext(vNames[i]);
+        }
+    }
+    report("LookupContext", start, ITERATIONS * nameCount);
+
+    start = now();
+    for (::u32 j = 0; j < ITERATIONS; j++) {
+        for (::u32 i = 0; i < nameCount; i++) {
+            sum += (unsigned long) htContextsByName.find(vNames[i])->second;
+        }
+    }
+    report("map<string, Context *>", start, ITERATIONS * nameCount);
+
+    start = now();
+    for (::u32 j = 0; j < ITERATIONS; j++) {
+        for (::u32 i = 0; i < typeInfoCount; i++) {
+            sum += (unsigned long) LookupStructure(*(vTypeInfos[i]));
+        }
+    }
+    report("LookupStructure", start, ITERATIONS * typeInfoCount);
+
+    start = now();
+    for (::u32 j = 0; j < ITERATIONS; j++) {
+        for (::u32 i = 0; i < typeInfoCount; i++) {
+            sum += (unsigned long) htStructuresByTypeinfo.find
+                (vTypeInfos[i]->name())->second;
+        }
+    }
+    report("map<string, Structure *>", start, ITERATIONS * typeInfoCount);
+
+    return (sum == 0);
+}
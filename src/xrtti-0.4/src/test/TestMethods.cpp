@@ -22,13 +22,17 @@
  * ------------------------------------------------------------------------- *
  *                                                                           *
  * This test just makes sure that the constructor, destructor, method        *
- * invoker, getter, and setter methods generated by xrttigen work properly   *
+ * invoker, getter, and setter methods generated by xrttigen work properly,  *
+ * and that members can be looked up by name and overloads resolved by       *
+ * argument Types, including through bases                                   *
  *                                                                           *
  \****************************************************************************/
 
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <vector>
 #include <Xrtti/Xrtti.h>
 #include <test/TestMethods.h>
 
@@ -71,6 +75,480 @@ static const Field *LookupField(const Class &classRef, const char *name)
 }
 
 
+// Looks up the members of TestMethods by name, checking against the linear
+// searches above, and members of its base classes through it
+static void test_base_lookup(const Class &classRef, TestMethods *pInstance)
+{
+    for (::u32 i = 0; i < classRef.GetFieldCount(); i++) {
+        const char *pName = classRef.GetField(i).GetName();
+        if (classRef.LookupField(pName) != LookupField(classRef, pName)) {
+            fprintf(stderr, "Failed to lookup TestMethods::%s\n", pName);
+            exit(-1);
+        }
+    }
+
+    for (::u32 i = 0; i < classRef.GetMethodCount(); i++) {
+        const Method &method = classRef.GetMethod(i);
+        MethodOverloads overloads = classRef.LookupMethods(method.GetName());
+        bool found = false;
+        for (::u32 j = 0; j < overloads.GetMethodCount(); j++) {
+            found = found || (&(overloads.GetMethod(j)) == &method);
+        }
+        if (!found) {
+            fprintf(stderr, "Failed to lookup TestMethods::%s\n", 
+                    method.GetName());
+            exit(-1);
+        }
+    }
+
+    void *pSecond = pInstance;
+    const Field *pField = classRef.LookupField("secondM", &pSecond);
+    if (!pField || (pSecond != (TestMethodsSecond *) pInstance) ||
+        (* ((::u32 *) pField->Get(pSecond)) != 2)) {
+        fprintf(stderr, "Failed to lookup TestMethodsSecond::secondM\n");
+        exit(-1);
+    }
+
+    void *pFirst = pInstance;
+    pField = classRef.LookupField("firstM", &pFirst);
+    if (!pField || (pFirst != (TestMethodsFirst *) pInstance) ||
+        (* ((::u32 *) pField->Get(pFirst)) != 1)) {
+        fprintf(stderr, "Failed to lookup TestMethodsFirst::firstM\n");
+        exit(-1);
+    }
+
+    pSecond = pInstance;
+    MethodOverloads overloads = classRef.LookupMethods("Second", &pSecond);
+    if ((overloads.GetMethodCount() != 2) ||
+        (pSecond != (TestMethodsSecond *) pInstance) ||
+        (overloads.GetMethod(0).GetSignature().GetArgumentCount() != 0) ||
+        (overloads.GetMethod(1).GetSignature().GetArgumentCount() != 1)) {
+        fprintf(stderr, "Failed to lookup TestMethodsSecond::Second\n");
+        exit(-1);
+    }
+
+    ::u32 ret, add = 3;
+    void *args[1] = { &add };
+    overloads.GetMethod(1).Invoke(pSecond, &ret, args);
+    printf("TestMethodsSecond Second: %u\n", ret);
+
+    // Resolve the overloads from argument Types, taking the Type of u32
+    // from secondM and the Type of s32 from Sum
+    const Type *pU32Type = &(pField->GetType());
+    const Type *pS32Type = 
+        &(LookupMethod(classRef, "Sum")->GetSignature().GetArgument(0).
+          GetType());
+    pSecond = pInstance;
+    if ((classRef.LookupMethod("Second", 0, 0) != 
+         &(overloads.GetMethod(0))) ||
+        (classRef.LookupMethod("Second", 1, &pU32Type, &pSecond) !=
+         &(overloads.GetMethod(1))) ||
+        (pSecond != (TestMethodsSecond *) pInstance) ||
+        classRef.LookupMethod("Second", 1, &pS32Type) ||
+        classRef.LookupMethod("Sum", 1, &pS32Type)) {
+        fprintf(stderr, "Failed to resolve TestMethodsSecond::Second\n");
+        exit(-1);
+    }
+
+    if (classRef.LookupField("noSuchM") || 
+        classRef.LookupMethods("NoSuch").GetMethodCount()) {
+        fprintf(stderr, "Looked up nonexistent TestMethods member\n");
+        exit(-1);
+    }
+
+    // Both bases declare these, so as in C++ they cannot be looked up
+    void *pShared = pInstance;
+    if (classRef.LookupField("sharedM", &pShared) || 
+        classRef.LookupMethods("Shared", &pShared).GetMethodCount() ||
+        (pShared != pInstance)) {
+        fprintf(stderr, "Looked up ambiguous TestMethods member\n");
+        exit(-1);
+    }
+}
+
+
+static void test_hierarchy(const Class &classRef, TestMethods *pInstance)
+{
+    const Structure *pFirst = 
+        (const Structure *) LookupContext("TestMethodsFirst");
+    const Structure *pSecond = 
+        (const Structure *) LookupContext("TestMethodsSecond");
+    if (!pFirst || !pSecond) {
+        fprintf(stderr, "Failed to lookup TestMethods bases\n");
+        exit(-1);
+    }
+
+    if (!IsSubclassOf(classRef, *pFirst) || !IsSubclassOf(classRef, *pSecond) ||
+        IsSubclassOf(*pFirst, classRef) || IsSubclassOf(*pFirst, *pSecond) ||
+        IsSubclassOf(classRef, classRef)) {
+        fprintf(stderr, "Wrong TestMethods subclass relationships\n");
+        exit(-1);
+    }
+
+    if ((GetDerivedCount(*pFirst) != 1) || 
+        (GetDerived(*pFirst, 0) != &classRef) ||
+        (GetDerivedCount(*pSecond) != 1) || 
+        (GetDerived(*pSecond, 0) != &classRef) ||
+        GetDerivedCount(classRef) || GetDerived(classRef, 0)) {
+        fprintf(stderr, "Wrong TestMethods subclasses\n");
+        exit(-1);
+    }
+
+    for (::u32 i = 0; i < classRef.GetBaseCount(); i++) {
+        const Base &base = classRef.GetBase(i);
+        if (!base.HasOffset() ||
+            (((char *) pInstance) + base.GetOffset() != 
+             base.CastSubclass(pInstance))) {
+            fprintf(stderr, "Wrong offset of TestMethods base %s\n",
+                    base.GetStructure().GetFullName());
+            exit(-1);
+        }
+    }
+
+    // Twice each, the second time using the cached path
+    for (::u32 i = 0; i < 2; i++) {
+        if ((Cast(pInstance, classRef, *pFirst) != 
+             (TestMethodsFirst *) pInstance) ||
+            (Cast(pInstance, classRef, *pSecond) != 
+             (TestMethodsSecond *) pInstance) ||
+            (Cast(pInstance, classRef, classRef) != pInstance) ||
+            Cast(pInstance, *pFirst, *pSecond) ||
+            Cast(0, classRef, *pSecond)) {
+            fprintf(stderr, "Failed to cast TestMethods\n");
+            exit(-1);
+        }
+    }
+
+    printf("TestMethods derives from %s and %s\n", pFirst->GetFullName(),
+           pSecond->GetFullName());
+}
+
+
+// Reads and writes the bitfields of TestMethodsBits through their Fields
+static void test_bits()
+{
+    const Structure *pBits = 
+        (const Structure *) LookupContext("TestMethodsBits");
+    if (!pBits) {
+        fprintf(stderr, "Failed to lookup TestMethodsBits\n");
+        exit(-1);
+    }
+
+    TestMethodsBits bits;
+    memset(&bits, 0, sizeof(bits));
+    bits.version = 4, bits.length = 5, bits.offset = -2, bits.flags = 6;
+    bits.ttl = 64;
+
+    const char *names[] = { "version", "length", "offset", "flags", "ttl" };
+    u64 values[] = { 4, 5, 0x1FFE, 6, 64 };
+    for (::u32 i = 0; i < (sizeof(names) / sizeof(names[0])); i++) {
+        const Field *pField = pBits->LookupDeclaredField(names[i]);
+        if (!pField || !pField->GetBitfieldStorageSize() ||
+            ((pField->GetBitfieldOffset() + 
+              pField->GetBitfieldStorageSize()) > sizeof(bits))) {
+            fprintf(stderr, "TestMethodsBits %s has no layout\n", names[i]);
+            exit(-1);
+        }
+        if (pField->GetBits(&bits) != values[i]) {
+            fprintf(stderr, "Bad TestMethodsBits %s bits\n", names[i]);
+            exit(-1);
+        }
+    }
+
+    // Setting one bitfield must leave its neighbours alone, and must
+    // truncate the value to the width of the bitfield
+    pBits->LookupDeclaredField("offset")->SetBits(&bits, 0x12345);
+    pBits->LookupDeclaredField("ttl")->SetBits(&bits, 255);
+    if ((bits.offset != 0x345) || (bits.ttl != 255) || (bits.version != 4) ||
+        (bits.length != 5) || (bits.flags != 6)) {
+        fprintf(stderr, "Failed to set TestMethodsBits bits\n");
+        exit(-1);
+    }
+}
+
+
+// Returns the Enumeration of the Field of TestMethodsEnums with the given name
+static const Enumeration &test_enumeration(const char *pName)
+{
+    const Structure *pEnums = 
+        (const Structure *) LookupContext("TestMethodsEnums");
+    const Field *pField = pEnums ? pEnums->LookupDeclaredField(pName) : 0;
+    if (!pField || 
+        (pField->GetType().GetBaseType() != Type::BaseType_Enumeration)) {
+        fprintf(stderr, "Failed to lookup TestMethodsEnums %s\n", pName);
+        exit(-1);
+    }
+
+    return ((const TypeEnumeration &) pField->GetType()).GetEnumeration();
+}
+
+
+// Looks up names and values of the TestMethodsEnums Enumerations, and
+// decomposes TestMethodsAccess values into flags
+static void test_enumerations()
+{
+    const Enumeration &color = test_enumeration("color");
+    const Enumeration &sparse = test_enumeration("sparse");
+    const Enumeration &access = test_enumeration("access");
+
+    // Every name and value, both ways
+    const Enumeration *enumerations[] = { &color, &sparse, &access };
+    for (::u32 i = 0; i < 3; i++) {
+        const Enumeration &enumeration = *(enumerations[i]);
+        for (::u32 j = 0; j < enumeration.GetValueCount(); j++) {
+            const EnumerationValue &value = enumeration.GetValue(j);
+            ::s32 found = 12345;
+            if (!enumeration.LookupValue(value.GetName(), &found) ||
+                (found != value.GetValue()) ||
+                !enumeration.LookupName(value.GetValue())) {
+                fprintf(stderr, "Failed to lookup %s\n", value.GetName());
+                exit(-1);
+            }
+        }
+    }
+
+    // The first name declared for a value, and missing names and values
+    ::s32 value = 12345;
+    if (strcmp(color.LookupName(Color_Crimson), "Color_Red") ||
+        strcmp(color.LookupName(Color_Blue), "Color_Blue") ||
+        color.LookupName(5) || color.LookupName(2) || color.LookupName(7) ||
+        strcmp(sparse.LookupName(Sparse_Low), "Sparse_Low") ||
+        sparse.LookupName(1) || sparse.LookupName(-100001) ||
+        sparse.LookupValue("Sparse_Middle", &value) ||
+        color.LookupValue("Color_", &value) || (value != 12345)) {
+        fprintf(stderr, "Bad TestMethodsEnums lookup\n");
+        exit(-1);
+    }
+
+    if (color.IsFlags() || sparse.IsFlags() || !access.IsFlags() ||
+        (access.GetFlagCount() != 3)) {
+        fprintf(stderr, "Bad TestMethodsAccess flags\n");
+        exit(-1);
+    }
+
+    // Write | Execute, and a bit which is not a flag
+    const EnumerationValue *flags[3];
+    ::s32 remainder;
+    ::u32 count = access.DecomposeFlags
+        (Access_Write | Access_Execute | 0x40, flags, &remainder);
+    if ((count != 2) || strcmp(flags[0]->GetName(), "Access_Write") ||
+        strcmp(flags[1]->GetName(), "Access_Execute") || (remainder != 0x40)) {
+        fprintf(stderr, "Bad TestMethodsAccess decomposition\n");
+        exit(-1);
+    }
+
+    printf("TestMethods Enumeration lookups passed\n");
+}
+
+
+// Checks the size and alignment generated for TestMethodsAbstract, which
+// cannot be instantiated, and for the Type of a reference to it
+static void test_abstract()
+{
+    const Struct *pAbstract = 
+        (const Struct *) LookupContext("TestMethodsAbstract");
+    if (!pAbstract || !pAbstract->IsAbstract() ||
+        (pAbstract->GetSizeof() != sizeof(TestMethodsAbstract)) ||
+        (pAbstract->GetAlignof() != __alignof__(TestMethodsAbstract))) {
+        fprintf(stderr, "Bad TestMethodsAbstract size or alignment\n");
+        exit(-1);
+    }
+
+    const Type &type = LookupMethod((const Class &) *pAbstract, "SameSize")->
+        GetSignature().GetArgument(0).GetType();
+    if (!type.IsReference() || !type.HasSizeof() ||
+        (type.GetSizeof() != sizeof(TestMethodsAbstract)) ||
+        (type.GetAlignof() != __alignof__(TestMethodsAbstract))) {
+        fprintf(stderr, "Bad TestMethodsAbstract reference Type size\n");
+        exit(-1);
+    }
+}
+
+
+// Checks the FieldLayouts of TestMethods::Inner and TestMethodsBits against
+// their Fields
+static void test_field_layout()
+{
+    const Structure *pInner = 
+        (const Structure *) LookupContext("TestMethods::Inner");
+    const FieldLayout *pLayout = pInner ? pInner->GetFieldLayout() : 0;
+    if (!pLayout || (pLayout[0].offset != offsetof(TestMethods::Inner, a)) ||
+        (pLayout[0].size != sizeof(::u32)) || (pLayout[0].extent != 1) ||
+        (pLayout[0].baseType != Type::BaseType_Unsigned_Int) ||
+        (pLayout[0].pointerDepth != 0) ||
+        (pLayout[0].flags != (FieldLayout::Flag_HasOffset |
+                              FieldLayout::Flag_Accessible)) ||
+        (pLayout[1].offset != offsetof(TestMethods::Inner, b)) ||
+        (pLayout[1].baseType != Type::BaseType_Float)) {
+        fprintf(stderr, "Bad TestMethods::Inner field layout\n");
+        exit(-1);
+    }
+
+    const Structure *pBits = 
+        (const Structure *) LookupContext("TestMethodsBits");
+    pLayout = pBits->GetFieldLayout();
+    for (::u32 i = 0; i < pBits->GetFieldCount(); i++) {
+        const Field &field = pBits->GetField(i);
+        if (!(pLayout[i].flags & FieldLayout::Flag_Bitfield) ||
+            !(pLayout[i].flags & FieldLayout::Flag_HasOffset) ||
+            (pLayout[i].offset != field.GetBitfieldOffset()) ||
+            (pLayout[i].size != field.GetBitfieldStorageSize()) ||
+            (pLayout[i].bitShift != field.GetBitfieldShift()) ||
+            (pLayout[i].extent != field.GetBitfieldBitCount())) {
+            fprintf(stderr, "Bad TestMethodsBits %s field layout\n",
+                    field.GetName());
+            exit(-1);
+        }
+    }
+}
+
+
+// Checks the sizes, alignments and element strides of TestMethods' Types
+static void test_type_sizes(const Class &classRef)
+{
+    const Type &counter = LookupField(classRef, "counterM")->GetType();
+    const Type &pointer = LookupField(classRef, "pInnerM")->GetType();
+    const Type &inners = LookupField(classRef, "innersM")->GetType();
+    const Type &grid = LookupField(classRef, "gridM")->GetType();
+    if (!counter.HasSizeof() || (counter.GetSizeof() != sizeof(::s16)) ||
+        (counter.GetAlignof() != sizeof(::s16)) ||
+        (pointer.GetSizeof() != sizeof(void *)) ||
+        (pointer.GetArrayOrPointer(0).GetElementStride() != 
+         sizeof(TestMethods::Inner)) ||
+        (inners.GetSizeof() != (3 * sizeof(TestMethods::Inner))) ||
+        (inners.GetAlignof() != ((const Structure *) LookupContext
+                                 ("TestMethods::Inner"))->GetAlignof()) ||
+        (inners.GetArrayOrPointer(0).GetElementStride() != 
+         sizeof(TestMethods::Inner)) ||
+        (grid.GetSizeof() != (4 * 8 * sizeof(unsigned short))) ||
+        (grid.GetArrayOrPointer(0).GetElementStride() != 
+         (8 * sizeof(unsigned short))) ||
+        (grid.GetArrayOrPointer(1).GetElementStride() != 
+         sizeof(unsigned short))) {
+        fprintf(stderr, "Bad TestMethods field Type sizes\n");
+        exit(-1);
+    }
+
+    // void has no size
+    const Type &identify = 
+        LookupMethod(classRef, "Identify")->GetSignature().GetReturnType();
+    const Type &allocate = 
+        LookupMethod(classRef, "Allocate")->GetSignature().GetReturnType();
+    if (identify.HasSizeof() || 
+        (allocate.GetArrayOrPointer(0).GetElementStride() != sizeof(::s32))) {
+        fprintf(stderr, "Bad TestMethods method Type sizes\n");
+        exit(-1);
+    }
+}
+
+
+// Checks that the Types of TestMethods' Fields and Methods share a
+// canonical Type exactly when they are Equals()
+static void test_canonical_types(const Class &classRef)
+{
+    std::vector<const Type *> types;
+    for (::u32 i = 0; i < classRef.GetFieldCount(); i++) {
+        types.push_back(&(classRef.GetField(i).GetType()));
+    }
+    for (::u32 i = 0; i < classRef.GetMethodCount(); i++) {
+        const MethodSignature &signature = 
+            classRef.GetMethod(i).GetSignature();
+        types.push_back(&(signature.GetReturnType()));
+        for (::u32 j = 0; j < signature.GetArgumentCount(); j++) {
+            types.push_back(&(signature.GetArgument(j).GetType()));
+        }
+    }
+
+    ::u32 shared = 0;
+    for (::u32 i = 0; i < types.size(); i++) {
+        const Type &canonical = types[i]->GetCanonical();
+        if ((&(canonical.GetCanonical()) != &canonical) ||
+            (canonical.GetBaseType() != types[i]->GetBaseType())) {
+            fprintf(stderr, "Bad canonical TestMethods Type\n");
+            exit(-1);
+        }
+        for (::u32 j = 0; j < i; j++) {
+            bool same = (&canonical == &(types[j]->GetCanonical()));
+            if (!same && Equals(*(types[i]), *(types[j]))) {
+                fprintf(stderr, "Equal TestMethods Types do not share a "
+                        "canonical Type\n");
+                exit(-1);
+            }
+            if (same && (types[i] != types[j])) {
+                shared++;
+            }
+        }
+    }
+
+    printf("TestMethods Types sharing a canonical Type: %lu\n", 
+           (unsigned long) shared);
+}
+
+
+// Resolves FieldPaths against TestMethods, and checks where they lead
+static void test_field_path(const Class &classRef, TestMethods *pInstance)
+{
+    TestMethods::Inner inner = { 3, 4.0 };
+    char *pBase = (char *) pInstance;
+    * (TestMethods::Inner **) LookupField(classRef, "pInnerM")->Get
+        (pInstance) = &inner;
+
+    FieldPath second(classRef, "secondM");
+    FieldPath innerB(classRef, "innerM.b");
+    FieldPath pointedB(classRef, "pInnerM->b");
+    FieldPath indexedB(classRef, "pInnerM[0].b");
+    FieldPath elementB(classRef, "innersM[2].b");
+    FieldPath element(classRef, "innersM[1]");
+    FieldPath cell(classRef, "gridM[2][5]");
+    if (!second.IsValid() || !innerB.IsValid() || !pointedB.IsValid() ||
+        !indexedB.IsValid() || !elementB.IsValid() || !element.IsValid() ||
+        !cell.IsValid() || (cell.GetIndexCount() != 2) ||
+        (element.GetIndexCount() != 1) ||
+        strcmp(elementB.GetField().GetName(), "b")) {
+        fprintf(stderr, "Failed to resolve TestMethods field paths\n");
+        exit(-1);
+    }
+
+    ::u32 innersOffset = LookupField(classRef, "innersM")->GetOffset();
+    if ((second.Evaluate(pInstance) != 
+         &(((TestMethodsSecond *) pInstance)->secondM)) ||
+        (innerB.Evaluate(pInstance) != &(pInstance->GetInnerRef().b)) ||
+        (pointedB.Evaluate(pInstance) != &(inner.b)) ||
+        (indexedB.Evaluate(pInstance) != &(inner.b)) ||
+        (elementB.Evaluate(pInstance) != 
+         (pBase + innersOffset + (2 * sizeof(TestMethods::Inner)) +
+          offsetof(TestMethods::Inner, b))) ||
+        (element.Evaluate(pInstance) != 
+         (pBase + innersOffset + sizeof(TestMethods::Inner))) ||
+        (cell.Evaluate(pInstance) != 
+         (pBase + LookupField(classRef, "gridM")->GetOffset() +
+          (((2 * 8) + 5) * sizeof(unsigned short))))) {
+        fprintf(stderr, "TestMethods field paths lead to the wrong place\n");
+        exit(-1);
+    }
+
+    // A NULL pointer on the way leads nowhere
+    * (TestMethods::Inner **) LookupField(classRef, "pInnerM")->Get
+        (pInstance) = 0;
+    if (pointedB.Evaluate(pInstance)) {
+        fprintf(stderr, "TestMethods field path followed NULL\n");
+        exit(-1);
+    }
+
+    const char *invalid[] = { "", "innerM.c", "innerM..a", "innerM->a", 
+                              "counterM[0]", "innersM[3]", "innersM[1",
+                              "innersM[-1]", "secondM.a", "innerM.a ",
+                              "gridM[4][0]", "gridM[0][8]" };
+    for (::u32 i = 0; i < (sizeof(invalid) / sizeof(invalid[0])); i++) {
+        if (FieldPath(classRef, invalid[i]).IsValid()) {
+            fprintf(stderr, "Resolved invalid field path \"%s\"\n", 
+                    invalid[i]);
+            exit(-1);
+        }
+    }
+}
+
+
 int main(int /* argc */, char ** /* argv */)
 {
     const Context *pContext = LookupContext("TestMethods");
@@ -158,6 +636,60 @@ int main(int /* argc */, char ** /* argv */)
         LookupMethod(classRef, "TestParams")->Invoke(pCreated, NULL, args);
     }
 
+    // Invoke "Sum", "GetInnerRef" and "TestParams" through bound methods
+    {
+        BoundMethod<s32 (s32, s32)> sum = 
+            LookupMethod(classRef, "Sum")->Bind<s32 (s32, s32)>();
+        BoundMethod<const TestMethods::Inner & ()> getInnerRef = 
+            LookupMethod(classRef, "GetInnerRef")->
+            Bind<const TestMethods::Inner & ()>();
+        BoundMethod<void (int, float &, char *, TestMethods::Inner, 
+                          TestMethods::Inner &, TestMethods::Inner *)>
+            testParams = LookupMethod(classRef, "TestParams")->
+            Bind<void (int, float &, char *, TestMethods::Inner, 
+                       TestMethods::Inner &, TestMethods::Inner *)>();
+        if (!sum.IsBound() || !getInnerRef.IsBound() || 
+            !testParams.IsBound() ||
+            LookupMethod(classRef, "Sum")->Bind<s32 (s32)>().IsBound() ||
+            LookupMethod(classRef, "Sum")->Bind<s16 (s32, s32)>().IsBound() ||
+            LookupMethod(classRef, "GetInnerRef")->
+            Bind<TestMethods::Inner ()>().IsBound()) {
+            fprintf(stderr, "Failed to bind TestMethods methods\n");
+            exit(-1);
+        }
+        printf("TestMethods bound Sum: %d\n", sum(pCreated, 3, 4));
+        printf("TestMethods bound GetInnerRef a: %u\n", 
+               getInnerRef(pCreated).a);
+        float arg2 = 2.0;
+        char arg3[] = "3";
+        TestMethods::Inner arg4 = { 4, 5.0 }, arg5 = { 6, 7.0 }, 
+            arg6 = { 8, 9.0 };
+        testParams(pCreated, 1, arg2, arg3, arg4, arg5, &arg6);
+    }
+
+    // Invoke "Sum" and "GetInnerRef" in batches; a stride of 0 invokes them
+    // on the same instance each time
+    {
+        const Method *pSum = LookupMethod(classRef, "Sum");
+        const Method *pGetInnerRef = LookupMethod(classRef, "GetInnerRef");
+        if (!pSum->IsBatchInvokeable() || !pGetInnerRef->IsBatchInvokeable()) {
+            fprintf(stderr, "TestMethods methods are not batch invokeable\n");
+            exit(-1);
+        }
+        s32 arg1[3] = { 1, 2, 3 }, arg2[3] = { 10, 20, 30 }, ret[3];
+        void *args[2] = { arg1, arg2 };
+        TestMethods::Inner *pRet[2];
+        if (!pSum->InvokeBatch(pCreated, 3, 0, ret, args) ||
+            !pSum->InvokeBatch(pCreated, 3, 0, NULL, args) ||
+            !pGetInnerRef->InvokeBatch(pCreated, 2, 0, pRet, NULL)) {
+            fprintf(stderr, "TestMethods batch invoke failed\n");
+            exit(-1);
+        }
+        printf("TestMethods batch Sum: %d %d %d\n", ret[0], ret[1], ret[2]);
+        printf("TestMethods batch GetInnerRef a: %u %u\n", pRet[0]->a,
+               pRet[1]->a);
+    }
+
     // Set "counterM" parameter
     {
         * ((s16 *) LookupField(classRef, "counterM")->Get(pCreated)) = 123;
@@ -192,6 +724,24 @@ int main(int /* argc */, char ** /* argv */)
                       pInner->a, pInner->b);
     }
 
+    test_base_lookup(classRef, pCreated);
+
+    test_hierarchy(classRef, pCreated);
+
+    test_bits();
+
+    test_enumerations();
+
+    test_abstract();
+
+    test_field_layout();
+
+    test_type_sizes(classRef);
+
+    test_canonical_types(classRef);
+
+    test_field_path(classRef, pCreated);
+
     // Delete it
     classRef.Delete(pCreated);
 
@@ -205,5 +755,111 @@ int main(int /* argc */, char ** /* argv */)
 
     // Delete them
     classRef.DeleteArray(pResult);
+
+    // Construct one in place through the Structure, then through the
+    // default Constructor, destroying each without freeing the memory
+    ::u32 alignment = classRef.GetAlignof();
+    if (!alignment || (alignment & (alignment - 1)) ||
+        (classRef.GetSizeof() % alignment)) {
+        fprintf(stderr, "Bad TestMethods alignment %u\n", alignment);
+        exit(-1);
+    }
+    void *pMemory = malloc(classRef.GetSizeof());
+    if (classRef.ConstructAt(pMemory) != pMemory) {
+        fprintf(stderr, "TestMethods ConstructAt moved the instance\n");
+        exit(-1);
+    }
+    LookupMethod(classRef, "Identify")->Invoke(pMemory, NULL, NULL);
+    classRef.DestroyAt(pMemory);
+    for (::u32 i = 0; i < classRef.GetConstructorCount(); i++) {
+        const Constructor &constructor = classRef.GetConstructor(i);
+        if (!constructor.GetSignature().GetArgumentCount() &&
+            constructor.IsInvokeable()) {
+            constructor.ConstructAt(pMemory, NULL);
+            LookupMethod(classRef, "Identify")->Invoke(pMemory, NULL, NULL);
+            classRef.DestroyAt(pMemory);
+        }
+    }
+    free(pMemory);
+
+    // Create and delete through an arena, and through a pool, which must
+    // reuse the memory of the deleted instance
+    {
+        ArenaAllocator arena(256);
+        TestMethods *pArenaArray =
+            (TestMethods *) classRef.CreateArray(3, arena);
+        TestMethods *pArenaCreated = (TestMethods *) classRef.Create(arena);
+        if (!pArenaArray || !pArenaCreated ||
+            (((uintptr_t) pArenaCreated) % alignment)) {
+            fprintf(stderr, "Failed to create TestMethods in an arena\n");
+            exit(-1);
+        }
+        LookupMethod(classRef, "Identify")->Invoke(pArenaCreated, NULL, NULL);
+        classRef.Delete(pArenaCreated, arena);
+        classRef.DeleteArray(pArenaArray, 3, arena);
+        arena.Reset();
+
+        PoolAllocator pool(classRef);
+        TestMethods *pPooled = (TestMethods *) classRef.Create(pool);
+        classRef.Delete(pPooled, pool);
+        if (!pPooled || (classRef.Create(pool) != pPooled) ||
+            classRef.CreateArray(2, pool)) {
+            fprintf(stderr, "TestMethods pool did not reuse memory\n");
+            exit(-1);
+        }
+        classRef.Delete(pPooled, pool);
+    }
+
+    // Copy and move TestMethods, which has a destructor, and so is neither
+    // trivially copyable nor trivially destructible, and then Inner, which
+    // is both
+    if (!classRef.IsCopyConstructible() || !classRef.IsCopyAssignable() ||
+        classRef.IsTriviallyCopyable() || 
+        classRef.IsTriviallyDestructible()) {
+        fprintf(stderr, "Bad TestMethods copy traits\n");
+        exit(-1);
+    }
+    {
+        TestMethods original, assigned;
+        assigned.secondM = 0;
+        original.secondM = 5;
+        pMemory = malloc(classRef.GetSizeof());
+        classRef.CopyConstruct(pMemory, &original);
+        classRef.CopyAssign(&assigned, pMemory);
+        if ((((TestMethods *) pMemory)->secondM != 5) ||
+            (assigned.secondM != 5)) {
+            fprintf(stderr, "Failed to copy TestMethods\n");
+            exit(-1);
+        }
+        classRef.DestroyAt(pMemory);
+        classRef.MoveConstruct(pMemory, &assigned);
+        original.secondM = 0;
+        classRef.MoveAssign(&original, pMemory);
+        if (original.secondM != 5) {
+            fprintf(stderr, "Failed to move TestMethods\n");
+            exit(-1);
+        }
+        classRef.DestroyAt(pMemory);
+        free(pMemory);
+    }
+
+    const Struct *pInner = 
+        (const Struct *) LookupContext("TestMethods::Inner");
+    if (!pInner || !pInner->IsTriviallyCopyable() || 
+        !pInner->IsTriviallyDestructible() || 
+        !pInner->IsTriviallyDefaultConstructible() ||
+        !pInner->IsStandardLayout()) {
+        fprintf(stderr, "TestMethods::Inner is not plain old data\n");
+        exit(-1);
+    }
+    {
+        TestMethods::Inner original = { 7, 8.0 }, copied = { 0, 0 };
+        pInner->CopyAssign(&copied, &original);
+        if ((copied.a != 7) || (copied.b != 8.0)) {
+            fprintf(stderr, "Failed to copy TestMethods::Inner\n");
+            exit(-1);
+        }
+    }
+
     return 0;
 }
@@ -39,14 +39,17 @@ namespace Xrtti {
 
 
 static const char *usageMessageG = 
-    "Usage: xrttigen [-D <definition>]... [-I <include_directory>]...\n"
+    "Usage: xrttigen [-D <definition>]... [-I <include_directory>]... [-b]\n"
     "                [-e <exclude_spec>]... [-h <header_file>]\n"
-    "                [-i <include_spec>]... [-n] [-o <output_file>]\n"
+    "                [-i <include_spec>]... [-n] [-o <output_file>] [-s]\n"
     "                [-t <tmp file>] input_header_file...\n\n"
     "  -D:   Defines a preprocessor macro to be used when processing all "
     "input\n        header fles.\n"
     "  -I:   Specifies a directory to search for header files included by "
     "input\n        header files.\n"
+    "  -b:   Also generates a batch invoke function for each method, which\n"
+    "        Method::InvokeBatch() uses to invoke the method on an array of\n"
+    "        instances in a single call.\n"
     "  -e:   Gives a specification of a class or a set of classes to exclude "
     "from\n        generation.  Includes and excludes are evaluated in the "
     "order that\n        they appear on the command line, with later includes "
@@ -63,6 +66,14 @@ static const char *usageMessageG =
     "being built without\n        C++ rtti support.\n"
     "  -o:   Names the output file to write the generated source to.  A "
     "value of\n        dash (-) indicates stdout.  Default is stdout.\n"
+    "  -s:   Registers the generated Xrtti code through a linker section "
+    "instead\n        of a static constructor, so that nothing is done at "
+    "load time; it\n        is registered on the first use of the Xrtti "
+    "registry.  The registry\n        must not be used before the "
+    "generated code has been statically\n        initialized.  A library "
+    "loaded after that first use is\n        registered when a lookup "
+    "misses, or Xrtti::RefreshContexts() is\n        called.  Requires a "
+    "GNU toolchain.\n"
     "  -t:   Names the temporary file which should be used to store gccxml "
     "xml\n        output; this file will be created and then deleted during "
     "the run of\n        xrttigen.  Defaults to gccxml.out in the current "
@@ -107,7 +118,8 @@ static bool IsOption(char *arg, const char *shortopt, const char *longopt)
 
 
 Configuration::Configuration(int argc, char **argv)
-	: disableRttiM(false), outFileM("-"), tmpFileM("gccxml.out")
+	: disableRttiM(false), sectionRegistrationM(false), batchInvokeM(false),
+	  outFileM("-"), tmpFileM("gccxml.out")
 {
 	int i;
 
@@ -140,6 +152,12 @@ Configuration::Configuration(int argc, char **argv)
 		else if (IsOption(argv[i], "-n", "no-rtti")) {
 			disableRttiM = true;
 		}
+		else if (IsOption(argv[i], "-b", "batch")) {
+			batchInvokeM = true;
+		}
+		else if (IsOption(argv[i], "-s", "section")) {
+			sectionRegistrationM = true;
+		}
 		else if (IsOption(argv[i], "-o", "output")) {
 			if (++i == argc) {
 				UsageExit(false);
@@ -24,8 +24,10 @@
 \*****************************************************************************/
 
 
+#include <algorithm>
 #include <fcntl.h>
 #include <string.h>
+#include <Xrtti/XrttiPrivate.h>
 #include <private/Generator.h>
 
 
@@ -41,6 +43,374 @@ namespace Xrtti {
 u32 GeneratorObject::nextNumberG = 1;
 
 
+// **************************************************************************
+// Structural fingerprints
+//
+// A fingerprint is a 128-bit hash of a canonical description of a Context,
+// which covers exactly what Equals() compares, so that two Contexts with
+// equal fingerprints are (with overwhelming probability) Equals().  Parts
+// of a Context which Equals() compares without regard to order are
+// described as a sorted list of the descriptions of their elements.
+// **************************************************************************
+
+static void describe_u32(string &description, u32 value)
+{
+    description.append(1, (char) (value & 0xFF));
+    description.append(1, (char) ((value >> 8) & 0xFF));
+    description.append(1, (char) ((value >> 16) & 0xFF));
+    description.append(1, (char) ((value >> 24) & 0xFF));
+}
+
+
+static void describe_string(string &description, const char *str)
+{
+    description.append(str, strlen(str) + 1);
+}
+
+
+// Appends a list of element descriptions in an order-independent way
+static void describe_set(string &description, vector<string> &vElements)
+{
+    sort(vElements.begin(), vElements.end());
+
+    describe_u32(description, vElements.size());
+
+    for (u32 i = 0; i < vElements.size(); i++) {
+        describe_u32(description, vElements[i].size());
+        description.append(vElements[i]);
+    }
+}
+
+
+static void describe_enumeration(string &description,
+                                 const Enumeration &enumeration)
+{
+    describe_u32(description, enumeration.GetAccessType());
+    describe_string(description, enumeration.GetContext().GetFullName());
+    describe_string(description, enumeration.GetName());
+
+    vector<string> vValues;
+    u32 count = enumeration.GetValueCount();
+    for (u32 i = 0; i < count; i++) {
+        const EnumerationValue &value = enumeration.GetValue(i);
+        string valueDescription;
+        describe_string(valueDescription, value.GetName());
+        describe_u32(valueDescription, (u32) value.GetValue());
+        vValues.push_back(valueDescription);
+    }
+    describe_set(description, vValues);
+}
+
+
+static void describe_signature(string &description,
+                               const DestructorSignature &signature);
+
+
+static void describe_type(string &description, const Type &type)
+{
+    describe_u32(description, type.GetBaseType());
+    describe_u32(description, type.IsConst());
+    describe_u32(description, type.IsVolatile());
+    describe_u32(description, type.IsReference());
+
+    u32 count = type.GetArrayOrPointerCount();
+    describe_u32(description, count);
+    for (u32 i = 0; i < count; i++) {
+        const ArrayOrPointer &arrayOrPointer = type.GetArrayOrPointer(i);
+        describe_u32(description, arrayOrPointer.GetType());
+        if (arrayOrPointer.GetType() == ArrayOrPointer::Type_Array) {
+            const Array &array = (const Array &) arrayOrPointer;
+            describe_u32(description, array.IsUnbounded());
+            describe_u32(description, array.GetElementCount());
+        }
+        else {
+            const Pointer &pointer = (const Pointer &) arrayOrPointer;
+            describe_u32(description, pointer.IsConst());
+            describe_u32(description, pointer.IsVolatile());
+        }
+    }
+
+    switch (type.GetBaseType()) {
+    case Type::BaseType_Enumeration:
+        describe_enumeration
+            (description, ((const TypeEnumeration &) type).GetEnumeration());
+        break;
+    case Type::BaseType_Function:
+        describe_signature
+            (description, ((const TypeFunction &) type).GetSignature());
+        describe_type
+            (description, 
+             ((const TypeFunction &) type).GetSignature().GetReturnType());
+        break;
+    case Type::BaseType_Structure:
+        describe_string
+            (description, 
+             ((const TypeStructure &) type).GetStructure().GetFullName());
+        break;
+    default:
+        break;
+    }
+}
+
+
+// Describes the throws of the signature, and if it is a
+// ConstructorSignature (which MethodSignature is as well), also the
+// arguments; the caller describes the return type of a MethodSignature
+static void describe_signature(string &description,
+                               const DestructorSignature &signature,
+                               bool hasArguments)
+{
+    vector<string> vThrows;
+    u32 count = signature.GetThrowCount();
+    for (u32 i = 0; i < count; i++) {
+        string throwDescription;
+        describe_type(throwDescription, signature.GetThrow(i));
+        vThrows.push_back(throwDescription);
+    }
+    describe_set(description, vThrows);
+
+    if (!hasArguments) {
+        return;
+    }
+
+    const ConstructorSignature &constructorSignature = 
+        (const ConstructorSignature &) signature;
+
+    count = constructorSignature.GetArgumentCount();
+    describe_u32(description, count);
+    for (u32 i = 0; i < count; i++) {
+        const Argument &argument = constructorSignature.GetArgument(i);
+        describe_type(description, argument.GetType());
+        describe_u32(description, argument.HasDefault());
+    }
+
+    describe_u32(description, constructorSignature.HasEllipsis());
+}
+
+
+static void describe_signature(string &description,
+                               const DestructorSignature &signature)
+{
+    describe_signature(description, signature, true);
+}
+
+
+static void describe_member(string &description, const Member &member)
+{
+    describe_u32(description, member.GetAccessType());
+    describe_string(description, member.GetContext().GetFullName());
+    describe_string(description, member.GetName());
+    describe_u32(description, member.IsStatic());
+}
+
+
+static void describe_method(string &description, const Method &method)
+{
+    describe_member(description, method);
+    describe_u32(description, method.IsOperatorMethod());
+    describe_u32(description, method.IsConst());
+    describe_u32(description, method.IsVirtual());
+    describe_u32(description, method.IsPureVirtual());
+
+    const MethodSignature &signature = method.GetSignature();
+    describe_signature(description, signature);
+    describe_type(description, signature.GetReturnType());
+
+    u32 count = signature.GetArgumentCount();
+    for (u32 i = 0; i < count; i++) {
+        describe_string(description, method.GetArgumentName(i));
+    }
+
+    describe_u32(description, method.IsInvokeable());
+}
+
+
+static void describe_context(string &description, const Context &context)
+{
+    describe_u32(description, context.GetType());
+    describe_string(description, context.GetName());
+    describe_string(description, context.GetFullName());
+    describe_string(description, context.GetContext() ?
+                    context.GetContext()->GetFullName() : "");
+
+    if (context.GetType() == Context::Type_Namespace) {
+        return;
+    }
+
+    const Structure &structure = (const Structure &) context;
+
+    describe_u32(description, structure.GetAccessType());
+
+    // Bases are compared in order, and deeply
+    u32 count = structure.GetBaseCount();
+    describe_u32(description, count);
+    for (u32 i = 0; i < count; i++) {
+        const Base &base = structure.GetBase(i);
+        describe_context(description, base.GetStructure());
+        describe_u32(description, base.IsCastable());
+    }
+
+    // Fields are compared in order
+    count = structure.GetFieldCount();
+    describe_u32(description, count);
+    for (u32 i = 0; i < count; i++) {
+        const Field &field = structure.GetField(i);
+        describe_member(description, field);
+        describe_u32(description, field.GetBitfieldBitCount());
+        describe_type(description, field.GetType());
+        describe_u32(description, field.GetOffset());
+        describe_u32(description, field.IsAccessible());
+    }
+
+    describe_u32(description, structure.IsAnonymous());
+
+    // Constructors are compared in any order
+    vector<string> vConstructors;
+    count = structure.GetConstructorCount();
+    for (u32 i = 0; i < count; i++) {
+        const Constructor &constructor = structure.GetConstructor(i);
+        string constructorDescription;
+        describe_member(constructorDescription, constructor);
+        describe_signature(constructorDescription, 
+                           constructor.GetSignature());
+        u32 argumentCount = constructor.GetSignature().GetArgumentCount();
+        for (u32 j = 0; j < argumentCount; j++) {
+            describe_string(constructorDescription, 
+                            constructor.GetArgumentName(j));
+        }
+        describe_u32(constructorDescription, constructor.IsInvokeable());
+        vConstructors.push_back(constructorDescription);
+    }
+    describe_set(description, vConstructors);
+
+    describe_u32(description, structure.HasDestructor());
+    if (structure.HasDestructor()) {
+        const Destructor &destructor = structure.GetDestructor();
+        describe_member(description, destructor);
+        describe_u32(description, destructor.IsVirtual());
+        describe_u32(description, destructor.IsPureVirtual());
+        describe_signature(description, destructor.GetSignature(), false);
+        describe_u32(description, destructor.IsInvokeable());
+    }
+
+    describe_u32(description, structure.IsCreatable());
+    describe_u32(description, structure.IsDeletable());
+
+    if (structure.GetType() == Context::Type_Union) {
+        return;
+    }
+
+    const Struct &structRef = (const Struct &) structure;
+
+    describe_u32(description, structRef.IsAbstract());
+
+    // Virtual methods are compared in order, and the rest in any order
+    vector<string> vMethods;
+    count = structRef.GetMethodCount();
+    describe_u32(description, count);
+    for (u32 i = 0; i < count; i++) {
+        const Method &method = structRef.GetMethod(i);
+        if (method.IsVirtual()) {
+            describe_method(description, method);
+        }
+        else {
+            string methodDescription;
+            describe_method(methodDescription, method);
+            vMethods.push_back(methodDescription);
+        }
+    }
+    describe_set(description, vMethods);
+}
+
+
+static u32 rotate_left(u32 value, u32 bits)
+{
+    return (value << bits) | (value >> (32 - bits));
+}
+
+
+static u32 final_mix(u32 value)
+{
+    value ^= value >> 16;
+    value *= 0x85ebca6bUL;
+    value ^= value >> 13;
+    value *= 0xc2b2ae35UL;
+    value ^= value >> 16;
+
+    return value;
+}
+
+
+// MurmurHash3_x86_128 of the description, with a zero seed
+static void hash_description(const string &description, u32 *pHash)
+{
+    static const u32 c[4] = { 0x239b961bUL, 0xab0e9789UL, 
+                              0x38b34ae5UL, 0xa1e38b93UL };
+    static const u32 rotations[4] = { 15, 16, 17, 18 };
+    static const u32 mixRotations[4] = { 19, 17, 15, 13 };
+    static const u32 mixConstants[4] = { 0x561ccd1bUL, 0x0bcaa747UL,
+                                         0x96cd1c35UL, 0x32ac3b17UL };
+
+    u32 h[4] = { 0, 0, 0, 0 };
+    const unsigned char *pData = 
+        (const unsigned char *) description.data();
+    u32 length = description.size();
+    u32 blockCount = length / 16;
+
+    for (u32 i = 0; i < blockCount; i++) {
+        for (u32 j = 0; j < 4; j++) {
+            const unsigned char *pWord = &(pData[(i * 16) + (j * 4)]);
+            u32 k = (pWord[0] | (pWord[1] << 8) | (pWord[2] << 16) |
+                     ((u32) pWord[3] << 24));
+            k *= c[j];
+            k = rotate_left(k, rotations[j]);
+            k *= c[(j + 1) % 4];
+            h[j] ^= k;
+            h[j] = rotate_left(h[j], mixRotations[j]);
+            h[j] += h[(j + 1) % 4];
+            h[j] = (h[j] * 5) + mixConstants[j];
+        }
+    }
+
+    // The tail, of up to 15 bytes
+    u32 k[4] = { 0, 0, 0, 0 };
+    const unsigned char *pTail = &(pData[blockCount * 16]);
+    for (u32 i = 0; i < (length & 15); i++) {
+        k[i / 4] ^= ((u32) pTail[i]) << ((i % 4) * 8);
+    }
+    for (u32 j = 0; j < 4; j++) {
+        if (k[j]) {
+            k[j] *= c[j];
+            k[j] = rotate_left(k[j], rotations[j]);
+            k[j] *= c[(j + 1) % 4];
+            h[j] ^= k[j];
+        }
+    }
+
+    for (u32 j = 0; j < 4; j++) {
+        h[j] ^= length;
+    }
+
+    h[0] += h[1] + h[2] + h[3];
+    h[1] += h[0];
+    h[2] += h[0];
+    h[3] += h[0];
+
+    for (u32 j = 0; j < 4; j++) {
+        h[j] = final_mix(h[j]);
+    }
+
+    h[0] += h[1] + h[2] + h[3];
+    h[1] += h[0];
+    h[2] += h[0];
+    h[3] += h[0];
+
+    for (u32 j = 0; j < 4; j++) {
+        pHash[j] = h[j];
+    }
+}
+
+
 Generator::Generator(Configuration &config, const ContextSet &contextSet)
     : configM(config)
 {
@@ -276,6 +646,33 @@ void Generator::EmitArrayArgument(FILE *file, u32 count,
 }
 
 
+static bool member_name_less(const std::pair<std::string, u32> &a,
+                             const std::pair<std::string, u32> &b)
+{
+    return (a.first < b.first);
+}
+
+
+/* static */
+void Generator::EmitArrayByName
+    (FILE *file, const char *type, const char *name, u32 number,
+     std::vector<std::pair<std::string, u32> > vMembers)
+{
+    // Overloads must stay in declaration order
+    std::stable_sort(vMembers.begin(), vMembers.end(), &member_name_less);
+
+    fprintf(file, "    static Xrtti::%s *_%lu_%s_by_name[] =\n    {\n",
+            type, (unsigned long) number, name);
+    u32 count = vMembers.size();
+    for (u32 i = 0; i < count; i++) {
+        fprintf(file, "        &_::_%lu%s\n", 
+                (unsigned long) vMembers[i].second,
+                (i < (count - 1)) ? "," : "");
+    }
+    fprintf(file, "    };\n\n");
+}
+
+
 /* static */
 bool Generator::IsAccessible(const Context *pContext)
 {
@@ -431,6 +828,172 @@ bool Generator::IsPod(const Context *pContext)
 }
 
 
+// Returns true if the type is the structure itself, or a reference to it
+static bool is_structure_type(const Xrtti::Type &type, 
+                              const Structure *pStructure)
+{
+    return (!type.GetArrayOrPointerCount() &&
+            (type.GetBaseType() == Xrtti::Type::BaseType_Structure) &&
+            !strcmp(((const TypeStructure &) type).GetStructure().
+                    GetFullName(), pStructure->GetFullName()));
+}
+
+
+// Returns the copy constructor, or if [assign] the copy assignment
+// operator, declared by the structure, or NULL if it has none and so has
+// an implicit one.  *pIsConst is set to whether it can copy from a const
+// instance.
+static const Member *find_copy_member(const Structure *pStructure, 
+                                      bool assign, bool *pIsConst)
+{
+    const Member *pMember = 0;
+    const Xrtti::Type *pType = 0;
+
+    if (assign) {
+        if (pStructure->GetType() == Context::Type_Union) {
+            return 0;
+        }
+        const Struct *pStruct = (const Struct *) pStructure;
+        u32 count = pStruct->GetMethodCount();
+        for (u32 i = 0; i < count; i++) {
+            const Method &method = pStruct->GetMethod(i);
+            if (method.IsOperatorMethod() && !strcmp(method.GetName(), "=") &&
+                (method.GetSignature().GetArgumentCount() == 1) &&
+                is_structure_type(method.GetSignature().GetArgument(0).
+                                  GetType(), pStructure)) {
+                pMember = &method;
+                pType = &(method.GetSignature().GetArgument(0).GetType());
+                break;
+            }
+        }
+    }
+    else {
+        u32 count = pStructure->GetConstructorCount();
+        for (u32 i = 0; i < count; i++) {
+            const Constructor &constructor = pStructure->GetConstructor(i);
+            if ((constructor.GetSignature().GetArgumentCount() == 1) &&
+                constructor.GetSignature().GetArgument(0).GetType().
+                IsReference() &&
+                is_structure_type(constructor.GetSignature().GetArgument(0).
+                                  GetType(), pStructure)) {
+                pMember = &constructor;
+                pType = &(constructor.GetSignature().GetArgument(0).
+                          GetType());
+                break;
+            }
+        }
+    }
+
+    // Assignment from a value of the structure also copies from a const
+    // instance
+    if (pMember) {
+        *pIsConst = pType->IsConst() || !pType->IsReference();
+    }
+
+    return pMember;
+}
+
+
+// Returns true if the structure can be copied; an implicit copy
+// constructor or assignment operator can copy only if each base and field
+// can, and an implicit assignment operator cannot assign a reference or
+// const field.  Declared ones must be accessible to the generated code for
+// the structure itself, and not private for its bases and fields.
+static bool is_copyable(const Structure *pStructure, bool assign, bool top)
+{
+    if (pStructure->IsIncomplete()) {
+        return false;
+    }
+
+    bool isConst;
+    const Member *pMember = find_copy_member(pStructure, assign, &isConst);
+    if (pMember) {
+        return isConst && 
+            (top ? Generator::IsAccessible(pMember) : 
+             (pMember->GetAccessType() != AccessType_Private));
+    }
+
+    u32 count = pStructure->GetBaseCount();
+    for (u32 i = 0; i < count; i++) {
+        if (!is_copyable(&(pStructure->GetBase(i).GetStructure()), assign, 
+                         false)) {
+            return false;
+        }
+    }
+
+    count = pStructure->GetFieldCount();
+    for (u32 i = 0; i < count; i++) {
+        const Field &field = pStructure->GetField(i);
+        if (field.IsStatic()) {
+            continue;
+        }
+
+        const Xrtti::Type &type = field.GetType();
+        if (type.IsReference()) {
+            if (assign) {
+                return false;
+            }
+            continue;
+        }
+
+        // Pointers are always copyable
+        bool isPointer = false;
+        u32 count2 = type.GetArrayOrPointerCount();
+        for (u32 j = 0; j < count2; j++) {
+            if (type.GetArrayOrPointer(j).GetType() == 
+                ArrayOrPointer::Type_Pointer) {
+                isPointer = true;
+                break;
+            }
+        }
+        if (isPointer) {
+            continue;
+        }
+
+        if (assign && type.IsConst()) {
+            return false;
+        }
+
+        if ((type.GetBaseType() == Xrtti::Type::BaseType_Structure) &&
+            !is_copyable(&(((const TypeStructure &) type).GetStructure()),
+                         assign, false)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/* static */
+bool Generator::IsCopyable(const Structure *pStructure, bool assign)
+{
+    return is_copyable(pStructure, assign, true);
+}
+
+
+/* static */
+void Generator::GetFingerprint(const Context *pContext, u32 *pFingerprint)
+{
+    string description;
+
+    describe_context(description, *pContext);
+
+    hash_description(description, pFingerprint);
+}
+
+
+/* static */
+void Generator::GetFingerprint(const Type *pType, u32 *pFingerprint)
+{
+    string description;
+
+    describe_type(description, *pType);
+
+    hash_description(description, pFingerprint);
+}
+
+
 /* static */
 string Generator::GetTypeName(const Context *pContext)
 {
@@ -503,6 +1066,7 @@ void Generator::EmitHeader(FILE *file)
             "*****************/\n\n");
 
     // Emit the "includes"
+    fprintf(file, "#include <new>\n");
     fprintf(file, "#include <stddef.h>\n");
     fprintf(file, "#include <typeinfo>\n");
     fprintf(file, "#include <Xrtti/XrttiPrivate.h>\n");
@@ -543,6 +1107,13 @@ void Generator::EmitXrttiAccess(FILE *file)
         (iter++)->second->EmitXrttiAccess(file);
     }
 
+    map<const Type *, GeneratorType *>::iterator typeIter = 
+        htGeneratorTypesM.begin();
+
+    while (typeIter != htGeneratorTypesM.end()) {
+        (typeIter++)->second->EmitXrttiAccess(file);
+    }
+
     fprintf(file, "};\n\n");
 }
 
@@ -631,6 +1202,20 @@ void Generator::EmitDefinitions(FILE *file)
 
 void Generator::EmitRegister(FILE *file)
 {
+    if (configM.GetSectionRegistration()) {
+        // These are defined within each object, __dso_handle by the C++
+        // runtime and the section bounds by the linker, so they are hidden
+        // so that each object's references are to its own
+        fprintf(file, "extern \"C\"\n{\n"
+                "    extern void *__dso_handle\n"
+                "        __attribute__((visibility(\"hidden\")));\n\n"
+                "    extern Xrtti::CompiledRegistration __start_%s[]\n"
+                "        __attribute__((visibility(\"hidden\")));\n\n"
+                "    extern Xrtti::CompiledRegistration __stop_%s[]\n"
+                "        __attribute__((visibility(\"hidden\")));\n}\n\n",
+                XRTTI_REGISTRY_SECTION, XRTTI_REGISTRY_SECTION);
+    }
+
     fprintf(file, "namespace\n{\n");
 
     if (htGeneratorContextsM.size()) {
@@ -646,15 +1231,132 @@ void Generator::EmitRegister(FILE *file)
         }
 
         fprintf(file, "    };\n\n");
+
+        // The hashes of the full names of the contexts, so that the
+        // registry can index them without hashing anything at startup
+        fprintf(file, "    static const Xrtti::u32 hashes[] =\n    {\n");
+
+        iter = htGeneratorContextsM.begin();
+
+        while (iter != htGeneratorContextsM.end()) {
+            const Context *pContext = (iter++)->first;
+            fprintf(file, "        0x%08lxUL%s\n", (unsigned long)
+                    CompiledContextSet::Hash(pContext->GetFullName()),
+                    (iter == htGeneratorContextsM.end()) ? "" : ",");
+        }
+
+        fprintf(file, "    };\n\n");
+
+        // The structural fingerprints of the contexts, so that the registry
+        // can tell whether two contexts with the same full name from
+        // different generated files are the same without comparing them
+        fprintf(file, "    static const Xrtti::u32 fingerprints[] =\n    {\n");
+
+        iter = htGeneratorContextsM.begin();
+
+        while (iter != htGeneratorContextsM.end()) {
+            u32 fingerprint[4];
+            Generator::GetFingerprint((iter++)->first, fingerprint);
+            fprintf(file, "        0x%08lxUL, 0x%08lxUL, 0x%08lxUL, "
+                    "0x%08lxUL%s\n", (unsigned long) fingerprint[0],
+                    (unsigned long) fingerprint[1], 
+                    (unsigned long) fingerprint[2],
+                    (unsigned long) fingerprint[3],
+                    (iter == htGeneratorContextsM.end()) ? "" : ",");
+        }
+
+        fprintf(file, "    };\n\n");
+    }
+
+    if (htGeneratorTypesM.size()) {
+        fprintf(file, "    static Xrtti::Type *types[] =\n    {\n");
+
+        map<const Type *, GeneratorType *>::iterator iter =
+            htGeneratorTypesM.begin();
+
+        while (iter != htGeneratorTypesM.end()) {
+            fprintf(file, "        &_::_%lu%s\n", 
+                    (unsigned long) (iter++)->second->GetNumber(),
+                    (iter == htGeneratorTypesM.end()) ? "" : ",");
+        }
+
+        fprintf(file, "    };\n\n");
+
+        // The structural fingerprints of the types, by which the registry
+        // interns them, so that equal types from different generated files
+        // share one canonical type
+        fprintf(file, "    static const Xrtti::u32 type_fingerprints[] =\n"
+                "    {\n");
+
+        iter = htGeneratorTypesM.begin();
+
+        while (iter != htGeneratorTypesM.end()) {
+            u32 fingerprint[4];
+            Generator::GetFingerprint((iter++)->first, fingerprint);
+            fprintf(file, "        0x%08lxUL, 0x%08lxUL, 0x%08lxUL, "
+                    "0x%08lxUL%s\n", (unsigned long) fingerprint[0],
+                    (unsigned long) fingerprint[1], 
+                    (unsigned long) fingerprint[2],
+                    (unsigned long) fingerprint[3],
+                    (iter == htGeneratorTypesM.end()) ? "" : ",");
+        }
+
+        fprintf(file, "    };\n\n");
+    }
+
+    if (configM.GetSectionRegistration()) {
+        this->EmitSectionRegistration(file);
+        return;
     }
 
     fprintf(file, "    static Xrtti::CompiledRegister registration\n    (\n"
-            "        %lu,\n        %s\n    );\n",
+            "        %lu,\n        %s,\n        %s,\n        %s,\n"
+            "        %lu,\n        %s,\n        %s\n    );\n",
             (unsigned long) htGeneratorContextsM.size(),
-            htGeneratorContextsM.size() ? "contexts" : "0");
+            htGeneratorContextsM.size() ? "contexts" : "0",
+            htGeneratorContextsM.size() ? "hashes" : "0",
+            htGeneratorContextsM.size() ? "fingerprints" : "0",
+            (unsigned long) htGeneratorTypesM.size(),
+            htGeneratorTypesM.size() ? "types" : "0",
+            htGeneratorTypesM.size() ? "type_fingerprints" : "0");
 
     fprintf(file, "}\n");
 }
 
 
+// Emits the registration of the contexts as a CompiledRegistration in the
+// registry section, which is statically initialized, instead of as a
+// CompiledRegister; this finishes the anonymous namespace opened by
+// EmitRegister()
+void Generator::EmitSectionRegistration(FILE *file)
+{
+    fprintf(file, "    Xrtti::CompiledRegistration registration\n"
+            "        __attribute__((section(\"%s\"), used,\n"
+            "                       aligned(sizeof(void *)))) =\n    {\n"
+            "        %lu,\n        %s,\n        %s,\n        %s,\n"
+            "        %lu,\n        %s,\n        %s,\n"
+            "        &__dso_handle,\n        0\n    };\n",
+            XRTTI_REGISTRY_SECTION,
+            (unsigned long) htGeneratorContextsM.size(),
+            htGeneratorContextsM.size() ? "contexts" : "0",
+            htGeneratorContextsM.size() ? "hashes" : "0",
+            htGeneratorContextsM.size() ? "fingerprints" : "0",
+            (unsigned long) htGeneratorTypesM.size(),
+            htGeneratorTypesM.size() ? "types" : "0",
+            htGeneratorTypesM.size() ? "type_fingerprints" : "0");
+
+    fprintf(file, "}\n\n");
+
+    // The linker defines the bounds of the section in each object, and the
+    // bounds symbol, of which each object keeps one definition, makes them
+    // available to the registry
+    fprintf(file, "extern \"C\"\n{\n"
+            "    Xrtti::CompiledRegistration *%s[2]\n"
+            "        __attribute__((weak, visibility(\"default\"))) =\n"
+            "    {\n        __start_%s,\n        __stop_%s\n    };\n}\n",
+            XRTTI_REGISTRY_BOUNDS_SYMBOL, XRTTI_REGISTRY_SECTION,
+            XRTTI_REGISTRY_SECTION);
+}
+
+
 }; // namespace Xrtti
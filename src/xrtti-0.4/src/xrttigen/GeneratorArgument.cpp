@@ -47,6 +47,12 @@ bool GeneratorArgument::IsPointer()
     return argumentM.GetType().GetArrayOrPointerCount();
 }
 
+bool GeneratorArgument::IsReference()
+{
+    return argumentM.GetType().IsReference();
+}
+
+
 bool GeneratorArgument::TypeIsConstNonPointer()
 {
     return (argumentM.GetType().IsConst() && 
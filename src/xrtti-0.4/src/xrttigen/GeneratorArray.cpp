@@ -38,7 +38,9 @@ void GeneratorArray::EmitDefinitionArguments(FILE *file)
 {
     Generator::EmitBooleanArgument(file, arrayM.IsUnbounded(), true);
 
-    Generator::EmitU32Argument(file, arrayM.GetElementCount(), false);
+    Generator::EmitU32Argument(file, arrayM.GetElementCount(), true);
+
+    this->EmitElementStrideArgument(file);
 }
 
 
@@ -57,6 +57,28 @@ void GeneratorBase::EmitXrttiAccess(FILE *file)
             pSubstructureM->GetTypeName().c_str());
 
     fprintf(file, "    };\n\n");
+
+    // Not a constant expression, so it is defined along with the other
+    // static definitions, ahead of the CompiledBase which uses it
+    if (this->CanEmitOffset()) {
+        fprintf(file, "    static const Xrtti::u32 _%lu_offset;\n\n",
+                (unsigned long) this->GetNumber());
+    }
+}
+
+
+void GeneratorBase::EmitXrttiAccessStaticDefinitions(FILE *file)
+{
+    if (!this->CanEmitOffset()) {
+        return;
+    }
+
+    // Any non-NULL address will do, since nothing is dereferenced
+    fprintf(file, "const Xrtti::u32 XrttiAccess::_%lu_offset = (Xrtti::u32)\n"
+            "    (((char *) (%s *) (%s *) 4096) - ((char *) 4096));\n\n",
+            (unsigned long) this->GetNumber(),
+            Generator::GetTypeName(&(baseM.GetStructure())).c_str(),
+            pSubstructureM->GetTypeName().c_str());
 }
 
 
@@ -70,10 +92,20 @@ void GeneratorBase::EmitDefinitionArguments(FILE *file)
             (unsigned long) pStructureM->GetNumber());
 
     if (this->CanEmitCast()) {
-        fprintf(file, "        &XrttiAccess::_%lu_cast", 
+        fprintf(file, "        &XrttiAccess::_%lu_cast,\n", 
+                (unsigned long) this->GetNumber());
+    }
+    else {
+        Generator::EmitU32Argument(file, 0, true);
+    }
+
+    if (this->CanEmitOffset()) {
+        Generator::EmitBooleanArgument(file, true, true);
+        fprintf(file, "        XrttiAccess::_%lu_offset", 
                 (unsigned long) this->GetNumber());
     }
     else {
+        Generator::EmitBooleanArgument(file, false, true);
         Generator::EmitU32Argument(file, 0, false);
     }
 }
@@ -86,4 +118,11 @@ bool GeneratorBase::CanEmitCast()
 }
 
 
+bool GeneratorBase::CanEmitOffset()
+{
+    // The offset of a virtual base depends upon the most derived type
+    return (this->CanEmitCast() && !baseM.IsVirtual());
+}
+
+
 }; // namespace Xrtti
@@ -84,6 +84,16 @@ void GeneratorConstructor::EmitXrttiAccess(FILE *file)
     constructorSignatureM.EmitInvokeArguments(file);
     
     fprintf(file, ");\n    }\n\n");
+
+    // The same, in memory given by the caller, for ConstructAt()
+    fprintf(file, "    static void *_%lu_construct_at(void *pMemory, "
+            "void **pArgs)\n    {\n        (void) pArgs;\n        "
+            "return ::new (pMemory) %s(", (unsigned long) this->GetNumber(), 
+            Generator::GetTypeName(&(constructorM.GetContext())).c_str());
+
+    constructorSignatureM.EmitInvokeArguments(file);
+    
+    fprintf(file, ");\n    }\n\n");
 }
 
 
@@ -127,10 +137,13 @@ void GeneratorConstructor::EmitDefinitionArguments(FILE *file)
     }
 
     if (Generator::IsAccessible(&constructorM) && this->CanInvoke()) {
-        fprintf(file, "        &XrttiAccess::_%lu_invoke", 
+        fprintf(file, "        &XrttiAccess::_%lu_invoke,\n", 
+                (unsigned long) this->GetNumber());
+        fprintf(file, "        &XrttiAccess::_%lu_construct_at", 
                 (unsigned long) this->GetNumber());
     }
     else {
+        Generator::EmitU32Argument(file, 0, true);
         Generator::EmitU32Argument(file, 0, false);
     }
 }
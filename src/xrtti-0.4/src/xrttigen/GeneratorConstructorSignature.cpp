@@ -98,6 +98,45 @@ void GeneratorConstructorSignature::EmitInvokeArguments(FILE *file)
 }
 
 
+void GeneratorConstructorSignature::EmitDirectInvokeParameters(FILE *file)
+{
+    u32 count = constructorSignatureM.GetArgumentCount();
+
+    for (u32 i = 0; i < count; i++) {
+        fprintf(file, ", %s_%lu_type %sa%lu", 
+                vArgumentsM[i]->TypeIsConstNonPointer() ? "const " : "",
+                (unsigned long) vArgumentsM[i]->GetTypeNumber(),
+                vArgumentsM[i]->IsReference() ? "&" : "", (unsigned long) i);
+    }
+}
+
+
+void GeneratorConstructorSignature::EmitDirectInvokeArguments(FILE *file)
+{
+    u32 count = constructorSignatureM.GetArgumentCount();
+
+    for (u32 i = 0; i < count; i++) {
+        fprintf(file, "a%lu%s", (unsigned long) i, 
+                (i < (count - 1)) ? ", " : "");
+    }
+}
+
+
+void GeneratorConstructorSignature::EmitBatchInvokeArguments(FILE *file)
+{
+    u32 count = constructorSignatureM.GetArgumentCount();
+
+    // Pointer arguments are not special here as they are in
+    // EmitInvokeArguments(), since each array holds the pointers themselves
+    for (u32 i = 0; i < count; i++) {
+        fprintf(file, "((%s_%lu_type *) pArgs[%lu])[i]%s",
+                vArgumentsM[i]->TypeIsConstNonPointer() ? "const " : "",
+                (unsigned long) vArgumentsM[i]->GetTypeNumber(),
+                (unsigned long) i, (i < (count - 1)) ? ", " : "");
+    }
+}
+
+
 void GeneratorConstructorSignature::EmitTypedefs(FILE *file)
 {
     u32 count = constructorSignatureM.GetArgumentCount();
@@ -24,6 +24,7 @@
 \*****************************************************************************/
 
 
+#include <algorithm>
 #include <private/Generator.h>
 
 
@@ -36,7 +37,7 @@ namespace Xrtti {
 
 GeneratorEnumeration::GeneratorEnumeration(Generator &generator, 
                                            const Enumeration &enumeration)
-    : enumerationM(enumeration)
+    : enumerationM(enumeration), isDenseM(false)
 {
     generator.RegisterGeneratorEnumeration(&enumeration, this);
 
@@ -48,7 +49,25 @@ GeneratorEnumeration::GeneratorEnumeration(Generator &generator,
         for (u32 i = 0; i < count; i++) {
             vValuesM[i] = new GeneratorEnumerationValue
                 (enumerationM.GetValue(i));
+            vByValueM.push_back(std::make_pair
+                                (enumerationM.GetValue(i).GetValue(), i));
         }
+
+        // Sorting by (value, index) keeps the first declared of each value
+        // first among those with that value
+        std::sort(vByValueM.begin(), vByValueM.end());
+        u32 distinct = 0;
+        for (u32 i = 0; i < count; i++) {
+            if (!distinct || 
+                (vByValueM[i].first != vByValueM[distinct - 1].first)) {
+                vByValueM[distinct++] = vByValueM[i];
+            }
+        }
+        vByValueM.resize(distinct);
+
+        u64 span = ((u32) vByValueM.back().first - 
+                    (u32) vByValueM.front().first) + 1ULL;
+        isDenseM = (span <= (2 * (u64) distinct));
     }
 }
 
@@ -87,6 +106,43 @@ void GeneratorEnumeration::EmitExtraDefinitions(FILE *file)
                     (i < (count - 1)) ? "," : "");
         }
         fprintf(file, "    };\n\n");
+
+        std::vector<std::pair<std::string, u32> > vNames(count);
+        for (u32 i = 0; i < count; i++) {
+            vNames[i].first = enumerationM.GetValue(i).GetName();
+            vNames[i].second = vValuesM[i]->GetNumber();
+        }
+        Generator::EmitArrayByName
+            (file, "EnumerationValue", "values", this->GetNumber(), vNames);
+
+        fprintf(file, "    static Xrtti::EnumerationValue "
+                "*_%lu_values_by_value[] =\n    {\n", 
+                (unsigned long) this->GetNumber());
+        u32 value = (u32) vByValueM.front().first;
+        for (u32 i = 0; i < vByValueM.size(); value++) {
+            // A dense table has a NULL entry for each missing value
+            if (isDenseM && ((u32) vByValueM[i].first != value)) {
+                fprintf(file, "        0,\n");
+                continue;
+            }
+            fprintf(file, "        &_::_%lu%s\n", 
+                    (unsigned long) vValuesM[vByValueM[i].second]->GetNumber(),
+                    (i < (vByValueM.size() - 1)) ? "," : "");
+            value = (u32) vByValueM[i++].first;
+        }
+        fprintf(file, "    };\n\n");
+    }
+
+    count = enumerationM.GetFlagCount();
+    if (count) {
+        fprintf(file, "    static Xrtti::EnumerationValue *_%lu_flags[] ="
+                "\n    {\n", (unsigned long) this->GetNumber());
+        for (u32 i = 0; i < count; i++) {
+            fprintf(file, "        &_::_%lu%s\n", 
+                    (unsigned long) this->GetValueNumber
+                    (enumerationM.GetFlag(i)), (i < (count - 1)) ? "," : "");
+        }
+        fprintf(file, "    };\n\n");
     }
 }
 
@@ -100,8 +156,54 @@ void GeneratorEnumeration::EmitDefinitionArguments(FILE *file)
 
     Generator::EmitStringArgument(file, enumerationM.GetName(), true);
 
-    Generator::EmitArrayArgument(file, enumerationM.GetValueCount(), 
-                                 "values", this->GetNumber(), false);
+    u32 count = enumerationM.GetValueCount();
+
+    Generator::EmitArrayArgument(file, count, "values", this->GetNumber(),
+                                 true);
+
+    // EnumerationValue **pValuesByName
+    if (count) {
+        fprintf(file, "        _%lu_values_by_name,\n", 
+                (unsigned long) this->GetNumber());
+    }
+    else {
+        Generator::EmitU32Argument(file, 0, true);
+    }
+
+    // bool isDense
+    Generator::EmitBooleanArgument(file, isDenseM, true);
+
+    // s32 firstValue
+    fprintf(file, "        %ld,\n", 
+            (long) (isDenseM ? vByValueM.front().first : 0));
+
+    // u32 byValueCount, EnumerationValue **pValuesByValue
+    u32 byValueCount = vByValueM.size();
+    if (isDenseM) {
+        byValueCount = ((u32) vByValueM.back().first - 
+                        (u32) vByValueM.front().first) + 1;
+    }
+    Generator::EmitArrayArgument(file, byValueCount, "values_by_value",
+                                 this->GetNumber(), true);
+
+    // u32 flagCount, EnumerationValue **pFlags
+    Generator::EmitArrayArgument(file, enumerationM.GetFlagCount(), "flags",
+                                 this->GetNumber(), true);
+
+    // bool isFlags
+    Generator::EmitBooleanArgument(file, enumerationM.IsFlags(), false);
+}
+
+
+u32 GeneratorEnumeration::GetValueNumber(const EnumerationValue &value)
+{
+    for (u32 i = 0; i < vValuesM.size(); i++) {
+        if (&(enumerationM.GetValue(i)) == &value) {
+            return vValuesM[i]->GetNumber();
+        }
+    }
+
+    return 0;
 }
 
 
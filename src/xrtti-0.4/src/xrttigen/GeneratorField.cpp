@@ -43,7 +43,8 @@ GeneratorField::GeneratorField(Generator &generator, const Field &field)
 
 void GeneratorField::EmitTypedefs(FILE *file)
 {
-    if (this->CanEmitGet() && fieldM.IsStatic() && fieldM.GetType().IsConst()) {
+    if ((this->CanEmitGet() && fieldM.IsStatic() && 
+         fieldM.GetType().IsConst()) || this->CanEmitClearBits()) {
         pTypeM->EmitTypedef(file);
     }    
 }
@@ -59,9 +60,34 @@ void GeneratorField::EmitXrttiAccess(FILE *file)
                 Generator::GetTypeName(&context).c_str(), fieldM.GetName());
     }
 
+    if (this->CanEmitSizeof()) {
+        if (fieldM.IsStatic()) {
+            fprintf(file, "    static const Xrtti::u32 _%lu_sizeof = "
+                    "sizeof(%s::%s);\n\n", (unsigned long) this->GetNumber(),
+                    fieldM.GetContext().GetFullName(), fieldM.GetName());
+        }
+        else {
+            fprintf(file, "    static const Xrtti::u32 _%lu_sizeof = "
+                    "sizeof(((%s *) 0)->%s);\n\n", 
+                    (unsigned long) this->GetNumber(),
+                    Generator::GetTypeName(&(fieldM.GetContext())).c_str(), 
+                    fieldM.GetName());
+        }
+    }
+
     if (this->CanEmitGet()) {
         this->EmitGet(file);
     }
+
+    // A bitfield has no address, so instead the library finds its bits by
+    // clearing it within a Structure whose bits are otherwise all set
+    if (this->CanEmitClearBits()) {
+        fprintf(file, "    static void _%lu_clear_bits(void *pThis)\n    {\n"
+                "        ((%s *) pThis)->%s = (_%lu_type) 0;\n    }\n\n",
+                (unsigned long) this->GetNumber(), 
+                Generator::GetTypeName(&(fieldM.GetContext())).c_str(), 
+                fieldM.GetName(), (unsigned long) pTypeM->GetNumber());
+    }
 }
 
 void GeneratorField::EmitXrttiAccessStaticDefinitions(FILE *file)
@@ -96,14 +122,105 @@ void GeneratorField::EmitDefinitionArguments(FILE *file)
 
     // get
     if (this->CanEmitGet()) {
-        fprintf(file, "        &XrttiAccess::_%lu_get", 
+        fprintf(file, "        &XrttiAccess::_%lu_get,\n", 
                 (unsigned long) this->GetNumber());
     }
     else {
+        Generator::EmitU32Argument(file, 0, true);
+    }
+
+    // containerSize, clearBits
+    if (this->CanEmitClearBits()) {
+        fprintf(file, "        sizeof(%s),\n"
+                "        &XrttiAccess::_%lu_clear_bits",
+                Generator::GetTypeName(&(fieldM.GetContext())).c_str(), 
+                (unsigned long) this->GetNumber());
+    }
+    else {
+        Generator::EmitU32Argument(file, 0, true);
         Generator::EmitU32Argument(file, 0, false);
     }
 }
 
+void GeneratorField::EmitFieldLayout(FILE *file, bool comma)
+{
+    const Type &type = fieldM.GetType();
+
+    // offset
+    fprintf(file, "        {\n");
+    if (this->CanEmitOffsetof()) {
+        fprintf(file, "            XrttiAccess::_%lu_offset,\n", 
+                (unsigned long) this->GetNumber());
+    }
+    else {
+        fprintf(file, "            0,\n");
+    }
+
+    // size
+    if (this->CanEmitSizeof()) {
+        fprintf(file, "            XrttiAccess::_%lu_sizeof,\n", 
+                (unsigned long) this->GetNumber());
+    }
+    else {
+        fprintf(file, "            0,\n");
+    }
+
+    // extent, pointerDepth
+    u32 extent = 1, pointerDepth = 0;
+    bool leading = true;
+    u32 count = type.GetArrayOrPointerCount();
+    for (u32 i = 0; i < count; i++) {
+        const ArrayOrPointer &arrayOrPointer = type.GetArrayOrPointer(i);
+        if (arrayOrPointer.GetType() == ArrayOrPointer::Type_Pointer) {
+            pointerDepth++;
+            leading = false;
+        }
+        else if (leading) {
+            const Array &array = (const Array &) arrayOrPointer;
+            extent *= array.IsUnbounded() ? 0 : array.GetElementCount();
+        }
+    }
+    if (fieldM.GetBitfieldBitCount()) {
+        extent = fieldM.GetBitfieldBitCount();
+    }
+    fprintf(file, "            %lu,\n", (unsigned long) extent);
+
+    // baseType
+    fprintf(file, "            Xrtti::%s,\n", pTypeM->GetBaseTypeName());
+
+    // pointerDepth, bitShift
+    fprintf(file, "            %lu,\n            0,\n", 
+            (unsigned long) pointerDepth);
+
+    // flags
+    std::string flags;
+    if (this->CanEmitOffsetof()) {
+        flags += " |\n            Xrtti::FieldLayout::Flag_HasOffset";
+    }
+    if (this->CanEmitGet()) {
+        flags += " |\n            Xrtti::FieldLayout::Flag_Accessible";
+    }
+    if (fieldM.IsStatic()) {
+        flags += " |\n            Xrtti::FieldLayout::Flag_Static";
+    }
+    if (fieldM.GetBitfieldBitCount()) {
+        flags += " |\n            Xrtti::FieldLayout::Flag_Bitfield";
+    }
+    if (type.IsConst()) {
+        flags += " |\n            Xrtti::FieldLayout::Flag_Const";
+    }
+    if (type.IsVolatile()) {
+        flags += " |\n            Xrtti::FieldLayout::Flag_Volatile";
+    }
+    if (type.IsReference()) {
+        flags += " |\n            Xrtti::FieldLayout::Flag_Reference";
+    }
+    fprintf(file, "            %s\n        }%s\n", 
+            flags.empty() ? "0" : &(flags.c_str()[15]),
+            comma ? "," : "");
+}
+
+
 static bool HasVirtualInheritence(const Structure &structure)
 {
     u32 count = structure.GetBaseCount();
@@ -180,6 +297,49 @@ bool GeneratorField::CanEmitGet()
 }
 
 
+bool GeneratorField::CanEmitSizeof()
+{
+    // sizeof a reference is the size of what it refers to, and an unbounded
+    // array has no size
+    if (!this->CanEmitGet() || fieldM.GetBitfieldBitCount() ||
+        fieldM.GetType().IsReference()) {
+        return false;
+    }
+
+    const Type &type = fieldM.GetType();
+    u32 count = type.GetArrayOrPointerCount();
+    for (u32 i = 0; i < count; i++) {
+        const ArrayOrPointer &arrayOrPointer = type.GetArrayOrPointer(i);
+        if (arrayOrPointer.GetType() == ArrayOrPointer::Type_Pointer) {
+            break;
+        }
+        if (((const Array &) arrayOrPointer).IsUnbounded()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+bool GeneratorField::CanEmitClearBits()
+{
+    if (!fieldM.GetBitfieldBitCount() || fieldM.IsStatic()) {
+        return false;
+    }
+
+    if (!fieldM.GetName()[0]) {
+        return false;
+    }
+
+    if (fieldM.GetContext().GetType() == Context::Type_Namespace) {
+        return false;
+    }
+
+    return Generator::IsAccessible(&fieldM);
+}
+
+
 void GeneratorField::EmitGet(FILE *file)
 {
     // First fake the field if it's a static const; this is the only way to
@@ -27,6 +27,8 @@
 #include <private/Generator.h>
 
 
+using namespace std;
+
 namespace Xrtti {
 
 #if 0 // This fixes indentation in emacs
@@ -36,7 +38,9 @@ namespace Xrtti {
 
 GeneratorMethod::GeneratorMethod(Generator &generator, const Method &method)
     : GeneratorMember(generator, (const Member &) method), methodM(method),
-      methodSignatureM(generator, method.GetSignature())
+      methodSignatureM(generator, method.GetSignature()),
+      batchInvokeM(generator.GetConfiguration().GetBatchInvoke()),
+      rttiM(generator.GetConfiguration().GetRtti())
 {
 }
 
@@ -100,6 +104,64 @@ void GeneratorMethod::EmitXrttiAccess(FILE *file)
     methodSignatureM.EmitInvokeArguments(file);
     
     fprintf(file, ");\n    }\n\n");
+
+    // The same, with the arguments passed by value, for Method::Bind()
+    string directReturnType = methodSignatureM.GetDirectInvokeReturnType();
+    fprintf(file, "    static %s _%lu_direct(void *pThis", 
+            directReturnType.c_str(), (unsigned long) this->GetNumber());
+    methodSignatureM.EmitDirectInvokeParameters(file);
+    fprintf(file, ")\n    {\n        %s((%s *) pThis)->%s%s(", 
+            (directReturnType == "void") ? "" : "return ",
+            Generator::GetTypeName(&(methodM.GetContext())).c_str(),
+            methodM.IsOperatorMethod() ? "operator " : "", methodM.GetName());
+    methodSignatureM.EmitDirectInvokeArguments(file);
+    fprintf(file, ");\n    }\n\n");
+
+    if (!batchInvokeM) {
+        return;
+    }
+
+    // The same, invoked on an array of instances, for Method::InvokeBatch()
+    fprintf(file, "    static void _%lu_invoke_batch(void *pThis, "
+            "Xrtti::u32 count,\n                                "
+            "Xrtti::u32 stride, void *pRet, void **pArgs)\n    {\n"
+            "        (void) pRet, (void) pArgs;\n        "
+            "char *pInstance = (char *) pThis;\n", 
+            (unsigned long) this->GetNumber());
+
+    if ((returnType.GetBaseType() != Type::BaseType_Void) ||
+        returnType.GetArrayOrPointerCount()) {
+        fprintf(file, "        if (pRet) {\n");
+        this->EmitBatchInvokeLoop(file, true);
+        fprintf(file, "            return;\n        }\n");
+    }
+
+    this->EmitBatchInvokeLoop(file, false);
+    fprintf(file, "    }\n\n");
+}
+
+
+void GeneratorMethod::EmitBatchInvokeLoop(FILE *file, bool storeReturn)
+{
+    const char *indent = storeReturn ? "    " : "";
+
+    fprintf(file, "%s        for (Xrtti::u32 i = 0; i < count; i++, "
+            "pInstance += stride) {\n%s            ", indent, indent);
+
+    if (storeReturn) {
+        const Type &returnType = methodM.GetSignature().GetReturnType();
+        bool refReturned = returnType.IsReference();
+        fprintf(file, "((%s_%lu_type *%s) pRet)[i] = %s", 
+                (returnType.IsConst() && refReturned) ? "const " : "",
+                (unsigned long) methodSignatureM.GetReturnTypeNumber(),
+                refReturned ? "*" : "", refReturned ? "& " : "");
+    }
+
+    fprintf(file, "((%s *) pInstance)->%s%s(", 
+            Generator::GetTypeName(&(methodM.GetContext())).c_str(),
+            methodM.IsOperatorMethod() ? "operator " : "", methodM.GetName());
+    methodSignatureM.EmitBatchInvokeArguments(file);
+    fprintf(file, ");\n%s        }\n", indent);
 }
 
 
@@ -151,10 +213,32 @@ void GeneratorMethod::EmitDefinitionArguments(FILE *file)
     }
 
     if (Generator::IsAccessible(&methodM) && this->CanInvoke()) {
-        fprintf(file, "        &XrttiAccess::_%lu_invoke", 
+        fprintf(file, "        &XrttiAccess::_%lu_invoke,\n", 
                 (unsigned long) this->GetNumber());
+        if (batchInvokeM) {
+            fprintf(file, "        &XrttiAccess::_%lu_invoke_batch,\n", 
+                    (unsigned long) this->GetNumber());
+        }
+        else {
+            Generator::EmitU32Argument(file, 0, true);
+        }
+        fprintf(file, "        (Xrtti::Method::DirectInvoke) "
+                "&XrttiAccess::_%lu_direct,\n", 
+                (unsigned long) this->GetNumber());
+        // Without RTTI, Bind() cannot check the type of the direct invoke
+        // function, and so does not bind it
+        if (rttiM) {
+            fprintf(file, "        &typeid(&XrttiAccess::_%lu_direct)", 
+                    (unsigned long) this->GetNumber());
+        }
+        else {
+            Generator::EmitU32Argument(file, 0, false);
+        }
     }
     else {
+        Generator::EmitU32Argument(file, 0, true);
+        Generator::EmitU32Argument(file, 0, true);
+        Generator::EmitU32Argument(file, 0, true);
         Generator::EmitU32Argument(file, 0, false);
     }
 }
@@ -24,9 +24,12 @@
 \*****************************************************************************/
 
 
+#include <private/StringUtils.h>
 #include <private/Generator.h>
 
 
+using namespace std;
+
 namespace Xrtti {
 
 #if 0 // This fixes indentation in emacs
@@ -50,6 +53,31 @@ u32 GeneratorMethodSignature::GetReturnTypeNumber()
 }
 
 
+string GeneratorMethodSignature::GetDirectInvokeReturnType()
+{
+    const Type &returnType = methodSignatureM.GetReturnType();
+
+    if ((returnType.GetBaseType() == Type::BaseType_Void) &&
+        !returnType.GetArrayOrPointerCount()) {
+        return "void";
+    }
+
+    // The const-ness of a returned scalar is ignored, and would draw a
+    // warning, so it is only kept for references and Structures
+    bool isConst = (returnType.IsConst() && 
+                    !returnType.GetArrayOrPointerCount() &&
+                    (returnType.IsReference() || 
+                     (returnType.GetBaseType() == 
+                      Type::BaseType_Structure)));
+
+    return (string(isConst ? "const " : "") + "_" + 
+            StringUtils::ToString
+            (StringUtils::Format(L"%lu", (unsigned long) 
+                                 pReturnTypeM->GetNumber())) +
+            "_type" + (returnType.IsReference() ? " &" : ""));
+}
+
+
 bool GeneratorMethodSignature::CanEmitReturnTypeAndArguments()
 {
     if (!pReturnTypeM->CanEmitTypedef()) {
@@ -38,7 +38,9 @@ void GeneratorPointer::EmitDefinitionArguments(FILE *file)
 {
     Generator::EmitBooleanArgument(file, pointerM.IsConst(), true);
 
-    Generator::EmitBooleanArgument(file, pointerM.IsVolatile(), false);
+    Generator::EmitBooleanArgument(file, pointerM.IsVolatile(), true);
+
+    this->EmitElementStrideArgument(file);
 }
 
 
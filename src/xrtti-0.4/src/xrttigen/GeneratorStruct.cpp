@@ -24,6 +24,7 @@
 \*****************************************************************************/
 
 
+#include <Xrtti/XrttiPrivate.h>
 #include <private/Generator.h>
 
 
@@ -113,6 +114,53 @@ void GeneratorStruct::EmitExtraDefinitions(FILE *file)
         }
 
         fprintf(file, "    };\n\n");
+
+        std::vector<std::pair<std::string, u32> > vMethods(count);
+        for (u32 i = 0; i < count; i++) {
+            vMethods[i].first = structM.GetMethod(i).GetName();
+            vMethods[i].second = vMethodsM[i]->GetNumber();
+        }
+        Generator::EmitArrayByName
+            (file, "Method", "methods", this->GetNumber(), vMethods);
+
+        // The overload table is kept at most half full, so that a probe for
+        // a missing Method ends quickly
+        u32 capacity = this->GetOverloadCapacity();
+        std::vector<u32> vHashes(capacity, 0);
+        std::vector<GeneratorMethod *> vSlots(capacity);
+        for (u32 i = 0; i < count; i++) {
+            const Method &method = structM.GetMethod(i);
+            const MethodSignature &signature = method.GetSignature();
+            u32 argumentCount = signature.GetArgumentCount();
+            std::vector<const Type *> vTypes(argumentCount);
+            for (u32 j = 0; j < argumentCount; j++) {
+                vTypes[j] = &(signature.GetArgument(j).GetType());
+            }
+            u32 hash = CompiledStruct::HashOverload
+                (method.GetName(), argumentCount, 
+                 argumentCount ? &(vTypes[0]) : 0);
+            u32 slot = hash & (capacity - 1);
+            while (vSlots[slot]) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            vHashes[slot] = hash;
+            vSlots[slot] = vMethodsM[i];
+        }
+
+        fprintf(file, "    static Xrtti::CompiledOverload _%lu_overloads[] ="
+                "\n    {\n", (unsigned long) this->GetNumber());
+        for (u32 i = 0; i < capacity; i++) {
+            if (vSlots[i]) {
+                fprintf(file, "        { %luUL, &_::_%lu }", 
+                        (unsigned long) vHashes[i], 
+                        (unsigned long) vSlots[i]->GetNumber());
+            }
+            else {
+                fprintf(file, "        { 0UL, 0 }");
+            }
+            fprintf(file, "%s\n", (i < (capacity - 1)) ? "," : "");
+        }
+        fprintf(file, "    };\n\n");
     }
 }
 
@@ -128,7 +176,35 @@ void GeneratorStruct::EmitDefinitionArguments(FILE *file)
     // methodCount
     // pMethods
     Generator::EmitArrayArgument
-        (file, structM.GetMethodCount(), "methods", this->GetNumber(), false);
+        (file, structM.GetMethodCount(), "methods", this->GetNumber(), true);
+
+    // pMethodsByName
+    // overloadCapacity
+    // pOverloads
+    if (structM.GetMethodCount()) {
+        fprintf(file, "        _%lu_methods_by_name,\n", 
+                (unsigned long) this->GetNumber());
+        Generator::EmitU32Argument(file, this->GetOverloadCapacity(), true);
+        fprintf(file, "        _%lu_overloads", 
+                (unsigned long) this->GetNumber());
+    }
+    else {
+        Generator::EmitU32Argument(file, 0, true);
+        Generator::EmitU32Argument(file, 0, true);
+        Generator::EmitU32Argument(file, 0, false);
+    }
+}
+
+
+u32 GeneratorStruct::GetOverloadCapacity()
+{
+    u32 capacity = 1;
+
+    while (capacity < (2 * structM.GetMethodCount())) {
+        capacity *= 2;
+    }
+
+    return capacity;
 }
 
 
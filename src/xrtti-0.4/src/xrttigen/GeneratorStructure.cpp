@@ -114,6 +114,18 @@ void GeneratorStructure::EmitXrttiAccess(FILE *file)
         fprintf(file, "    static const Xrtti::u32 _%lu_sizeof = "
                 "sizeof(%s);\n\n", (unsigned long) this->GetNumber(),
                 structureM.GetFullName());
+        fprintf(file, "    static const Xrtti::u32 _%lu_alignof = "
+                "Xrtti::CompiledAlignof<%s >::value;\n\n", 
+                (unsigned long) this->GetNumber(), structureM.GetFullName());
+        fprintf(file, "#if __cplusplus >= 201103L\n    static const "
+                "Xrtti::u32 _%lu_traits =\n        "
+                "Xrtti::CompiledTraits<%s >::value;\n#else\n"
+                "    static const Xrtti::u32 _%lu_traits = %s;\n"
+                "#endif\n\n", (unsigned long) this->GetNumber(), 
+                structureM.GetFullName(), (unsigned long) this->GetNumber(),
+                (Generator::IsPod(&structureM) && 
+                 !structureM.HasDestructor()) ? 
+                "Xrtti::CompiledTrait_Pod" : "0");
         if (rttiM) {
             fprintf(file, "    static const std::type_info "
                     "*_%lu_get_typeinfo()\n    {\n        "
@@ -180,6 +192,13 @@ void GeneratorStructure::EmitXrttiAccess(FILE *file)
                 "    {\n", (unsigned long) this->GetNumber());
         fprintf(file, "        return new %s[count];\n    }\n\n", 
                 Generator::GetTypeName(&structureM).c_str());
+
+        // constructat; the global placement new is used even if the
+        // structure declares its own operator new
+        fprintf(file, "    static void *_%lu_construct_at(void *pMemory)\n"
+                "    {\n", (unsigned long) this->GetNumber());
+        fprintf(file, "        return ::new (pMemory) %s();\n    }\n\n", 
+                Generator::GetTypeName(&structureM).c_str());
     }
 
     if (this->CanInvokeDefaultDestructor()) {
@@ -194,13 +213,65 @@ void GeneratorStructure::EmitXrttiAccess(FILE *file)
                 (unsigned long) this->GetNumber());
         fprintf(file, "        delete [] (%s *) pThis;\n    }\n\n", 
                 Generator::GetTypeName(&structureM).c_str());
+
+        // destroyat; the destructor is named through a typedef, since the
+        // type name may be qualified
+        fprintf(file, "    static void _%lu_destroy_at(void *pThis)\n    {\n",
+                (unsigned long) this->GetNumber());
+        fprintf(file, "        typedef %s _type;\n"
+                "        ((_type *) pThis)->~_type();\n    }\n\n", 
+                Generator::GetTypeName(&structureM).c_str());
+    }
+
+    // The moves are only moves when compiled as C++11, and otherwise copy
+    std::string typeName = Generator::GetTypeName(&structureM);
+    const char *pTypeName = typeName.c_str();
+    if (this->CanCopy(false)) {
+        // copyconstruct
+        fprintf(file, "    static void *_%lu_copy_construct(void *pMemory, "
+                "const void *pOther)\n    {\n", 
+                (unsigned long) this->GetNumber());
+        fprintf(file, "        return ::new (pMemory) %s(* (const %s *) "
+                "pOther);\n    }\n\n", pTypeName, pTypeName);
+
+        // moveconstruct
+        fprintf(file, "    static void *_%lu_move_construct(void *pMemory, "
+                "void *pOther)\n    {\n", (unsigned long) this->GetNumber());
+        fprintf(file, "#if __cplusplus >= 201103L\n        return ::new "
+                "(pMemory) %s(static_cast<%s &&>(* (%s *) pOther));\n#else\n"
+                "        return ::new (pMemory) %s(* (const %s *) pOther);\n"
+                "#endif\n    }\n\n", pTypeName, pTypeName, pTypeName,
+                pTypeName, pTypeName);
+    }
+
+    if (this->CanCopy(true)) {
+        // copyassign
+        fprintf(file, "    static void _%lu_copy_assign(void *pThis, "
+                "const void *pOther)\n    {\n", 
+                (unsigned long) this->GetNumber());
+        fprintf(file, "        * (%s *) pThis = * (const %s *) pOther;\n"
+                "    }\n\n", pTypeName, pTypeName);
+
+        // moveassign
+        fprintf(file, "    static void _%lu_move_assign(void *pThis, "
+                "void *pOther)\n    {\n", (unsigned long) this->GetNumber());
+        fprintf(file, "#if __cplusplus >= 201103L\n        * (%s *) pThis = "
+                "static_cast<%s &&>(* (%s *) pOther);\n#else\n"
+                "        * (%s *) pThis = * (const %s *) pOther;\n"
+                "#endif\n    }\n\n", pTypeName, pTypeName, pTypeName,
+                pTypeName, pTypeName);
     }
 }
 
 
 void GeneratorStructure::EmitXrttiAccessStaticDefinitions(FILE *file)
 {
-    u32 count = structureM.GetFieldCount();
+    u32 count = structureM.GetBaseCount();
+    for (u32 i = 0; i < count; i++) {
+        vBasesM[i]->EmitXrttiAccessStaticDefinitions(file);
+    }
+
+    count = structureM.GetFieldCount();
     for (u32 i = 0; i < count; i++) {
         vFieldsM[i]->EmitXrttiAccessStaticDefinitions(file);
     }
@@ -248,6 +319,20 @@ bool GeneratorStructure::CanInvokeDefaultConstructor()
 }
 
 
+bool GeneratorStructure::CanCopy(bool assign)
+{
+    if (structureM.IsAnonymous() || structureM.IsIncomplete() ||
+        (((structureM.GetType() == Context::Type_Class) ||
+          (structureM.GetType() == Context::Type_Struct)) &&
+         ((const Struct &) structureM).IsAbstract()) ||
+        !Generator::IsAccessible(&structureM)) {
+        return false;
+    }
+
+    return Generator::IsCopyable(&structureM, assign);
+}
+
+
 bool GeneratorStructure::CanInvokeDefaultDestructor()
 {
     if (!Generator::IsAccessible(&structureM)) {
@@ -327,6 +412,22 @@ void GeneratorStructure::EmitExtraDefinitions(FILE *file)
                     (i < (count - 1)) ? "," : "");
         }
         fprintf(file, "    };\n\n");
+
+        std::vector<std::pair<std::string, u32> > vFields(count);
+        for (u32 i = 0; i < count; i++) {
+            vFields[i].first = structureM.GetField(i).GetName();
+            vFields[i].second = vFieldsM[i]->GetNumber();
+        }
+        Generator::EmitArrayByName
+            (file, "Field", "fields", this->GetNumber(), vFields);
+
+        // Not const, since the layout of bitfields is filled in at runtime
+        fprintf(file, "    static Xrtti::FieldLayout _%lu_field_layout[] ="
+                "\n    {\n", (unsigned long) this->GetNumber());
+        for (u32 i = 0; i < count; i++) {
+            vFieldsM[i]->EmitFieldLayout(file, (i < (count - 1)));
+        }
+        fprintf(file, "    };\n\n");
     }
 
     count = structureM.GetConstructorCount();
@@ -361,15 +462,19 @@ void GeneratorStructure::EmitDefinitionArguments(FILE *file)
 
     // bool hasSizeof
     // u32 sizeof
+    // u32 alignof
     if (structureM.IsIncomplete() || structureM.IsAnonymous() ||
         !Generator::IsAccessible(&structureM)) {
         Generator::EmitBooleanArgument(file, false, true);
         Generator::EmitU32Argument(file, 0, true);
+        Generator::EmitU32Argument(file, 0, true);
     }
     else {
         Generator::EmitBooleanArgument(file, true, true);
         fprintf(file, "        XrttiAccess::_%lu_sizeof,\n", 
                 (unsigned long) this->GetNumber());
+        fprintf(file, "        XrttiAccess::_%lu_alignof,\n", 
+                (unsigned long) this->GetNumber());
     }
 
     // bool hasStructureName
@@ -403,6 +508,19 @@ void GeneratorStructure::EmitDefinitionArguments(FILE *file)
     Generator::EmitArrayArgument
         (file, structureM.GetFieldCount(), "fields", this->GetNumber(), true);
 
+    // CompiledField **pFieldsByName
+    // FieldLayout *pFieldLayout
+    if (structureM.GetFieldCount()) {
+        fprintf(file, "        _%lu_fields_by_name,\n", 
+                (unsigned long) this->GetNumber());
+        fprintf(file, "        _%lu_field_layout,\n", 
+                (unsigned long) this->GetNumber());
+    }
+    else {
+        Generator::EmitU32Argument(file, 0, true);
+        Generator::EmitU32Argument(file, 0, true);
+    }
+
     // bool isAnonymous
     Generator::EmitBooleanArgument(file, structureM.IsAnonymous(), true);
 
@@ -439,7 +557,61 @@ void GeneratorStructure::EmitDefinitionArguments(FILE *file)
     if (this->CanInvokeDefaultDestructor()) {
         fprintf(file, "        &XrttiAccess::_%lu_delete,\n", 
                 (unsigned long) this->GetNumber());
-        fprintf(file, "        &XrttiAccess::_%lu_delete_array",
+        fprintf(file, "        &XrttiAccess::_%lu_delete_array,\n",
+                (unsigned long) this->GetNumber());
+    }
+    else {
+        Generator::EmitU32Argument(file, 0, true);
+        Generator::EmitU32Argument(file, 0, true);
+    }
+
+    // CompiledConstructAt *pConstructAt
+    if (this->CanInvokeDefaultConstructor()) {
+        fprintf(file, "        &XrttiAccess::_%lu_construct_at,\n", 
+                (unsigned long) this->GetNumber());
+    }
+    else {
+        Generator::EmitU32Argument(file, 0, true);
+    }
+
+    // CompiledDestroyAt *pDestroyAt
+    if (this->CanInvokeDefaultDestructor()) {
+        fprintf(file, "        &XrttiAccess::_%lu_destroy_at,\n",
+                (unsigned long) this->GetNumber());
+    }
+    else {
+        Generator::EmitU32Argument(file, 0, true);
+    }
+
+    // u32 traits
+    if (structureM.IsIncomplete() || structureM.IsAnonymous() ||
+        !Generator::IsAccessible(&structureM)) {
+        Generator::EmitU32Argument(file, 0, true);
+    }
+    else {
+        fprintf(file, "        XrttiAccess::_%lu_traits,\n", 
+                (unsigned long) this->GetNumber());
+    }
+
+    // CompiledCopyConstruct *pCopyConstruct
+    // CompiledMoveConstruct *pMoveConstruct
+    if (this->CanCopy(false)) {
+        fprintf(file, "        &XrttiAccess::_%lu_copy_construct,\n", 
+                (unsigned long) this->GetNumber());
+        fprintf(file, "        &XrttiAccess::_%lu_move_construct,\n", 
+                (unsigned long) this->GetNumber());
+    }
+    else {
+        Generator::EmitU32Argument(file, 0, true);
+        Generator::EmitU32Argument(file, 0, true);
+    }
+
+    // CompiledCopyAssign *pCopyAssign
+    // CompiledMoveAssign *pMoveAssign
+    if (this->CanCopy(true)) {
+        fprintf(file, "        &XrttiAccess::_%lu_copy_assign,\n", 
+                (unsigned long) this->GetNumber());
+        fprintf(file, "        &XrttiAccess::_%lu_move_assign", 
                 (unsigned long) this->GetNumber());
     }
     else {
@@ -49,11 +49,11 @@ GeneratorType::GeneratorType(Generator &generator, const Type &type)
             const ArrayOrPointer &arrayOrPointer = type.GetArrayOrPointer(i);
             if (arrayOrPointer.GetType() == ArrayOrPointer::Type_Array) {
                 vArrayOrPointersM[i] = new GeneratorArray
-                    ((const Array &) arrayOrPointer);
+                    (*this, i, (const Array &) arrayOrPointer);
             }
             else {
                 vArrayOrPointersM[i] = new GeneratorPointer
-                    ((const Pointer &) arrayOrPointer);
+                    (*this, i, (const Pointer &) arrayOrPointer);
             }
         }
     }
@@ -88,6 +88,65 @@ void GeneratorType::EmitTypedef(FILE *file)
     fprintf(file, ";\n\n");
 }
 
+void GeneratorType::EmitXrttiAccess(FILE *file)
+{
+    if (!this->CanEmitTypedef()) {
+        return;
+    }
+
+    u32 count = typeM.GetArrayOrPointerCount();
+    bool sized = this->IsSized(0);
+    for (u32 i = 0; !sized && (i < count); i++) {
+        sized = this->HasElementStride(i);
+    }
+    if (!sized) {
+        return;
+    }
+
+    this->EmitTypedef(file);
+
+    unsigned long number = (unsigned long) this->GetNumber();
+    if (this->IsSized(0)) {
+        fprintf(file, "    static const Xrtti::u32 _%lu_sizeof = "
+                "sizeof(_%lu_type);\n\n", number, number);
+        fprintf(file, "    static const Xrtti::u32 _%lu_alignof = "
+                "Xrtti::CompiledAlignof<_%lu_type >::value;\n\n", 
+                number, number);
+    }
+
+    // The element at level i is reached by subscripting i + 1 times
+    string element = "(*(_" + StringUtils::ToString
+        (StringUtils::Format(L"%lu", number)) + "_type *) 0)";
+    for (u32 i = 0; i < count; i++) {
+        element += "[0]";
+        if (this->HasElementStride(i)) {
+            fprintf(file, "    static const Xrtti::u32 _%lu_stride = "
+                    "sizeof(%s);\n\n", 
+                    (unsigned long) vArrayOrPointersM[i]->GetNumber(),
+                    element.c_str());
+        }
+    }
+}
+
+
+bool GeneratorType::HasElementStride(u32 index)
+{
+    if (!this->CanEmitTypedef()) {
+        return false;
+    }
+
+    // Subscripting through each level up to this one needs each of their
+    // elements to be sized too
+    for (u32 i = 0; i <= index; i++) {
+        if (!this->IsSized(i + 1)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
 void GeneratorType::EmitTypedefContents(FILE *file)
 {
     // typedef type_name
@@ -175,6 +234,17 @@ void GeneratorType::EmitDefinitionArguments(FILE *file)
 
     Generator::EmitBooleanArgument(file, typeM.IsReference(), true);
 
+    if (this->CanEmitTypedef() && this->IsSized(0)) {
+        fprintf(file, "        XrttiAccess::_%lu_sizeof,\n", 
+                (unsigned long) this->GetNumber());
+        fprintf(file, "        XrttiAccess::_%lu_alignof,\n", 
+                (unsigned long) this->GetNumber());
+    }
+    else {
+        Generator::EmitU32Argument(file, 0, true);
+        Generator::EmitU32Argument(file, 0, true);
+    }
+
     Generator::EmitArrayArgument
         (file, typeM.GetArrayOrPointerCount(), "array_or_pointers", 
          this->GetNumber(), false);
@@ -273,6 +343,41 @@ const char *GeneratorType::GetBaseTypeName()
     }
 }
 
+bool GeneratorType::IsSized(u32 index)
+{
+    if (index < typeM.GetArrayOrPointerCount()) {
+        const ArrayOrPointer &arrayOrPointer = typeM.GetArrayOrPointer(index);
+        if (arrayOrPointer.GetType() == ArrayOrPointer::Type_Pointer) {
+            return true;
+        }
+        return (!((const Array &) arrayOrPointer).IsUnbounded() &&
+                this->IsSized(index + 1));
+    }
+
+    switch (typeM.GetBaseType()) {
+    case Type::BaseType_Void:
+    case Type::BaseType_Function:
+        return false;
+    case Type::BaseType_Structure:
+        return !((const TypeStructure &) typeM).GetStructure().IsIncomplete();
+    default:
+        return true;
+    }
+}
+
+
+void GeneratorArrayOrPointer::EmitElementStrideArgument(FILE *file)
+{
+    if (typeM.HasElementStride(indexM)) {
+        fprintf(file, "        XrttiAccess::_%lu_stride", 
+                (unsigned long) this->GetNumber());
+    }
+    else {
+        Generator::EmitU32Argument(file, 0, false);
+    }
+}
+
+
 string GeneratorType::GetCppTypeName()
 {
     switch (typeM.GetBaseType()) {
@@ -312,6 +417,11 @@ string GeneratorType::GetCppTypeName()
         {
             const Enumeration &enumeration = 
                 ((const TypeEnumeration &) typeM).GetEnumeration();
+            // Like Contexts, an enum of the global namespace is not
+            // prefixed with its name, which is "::"
+            if (!enumeration.GetContext().GetContext()) {
+                return enumeration.GetName();
+            }
             return (string(enumeration.GetContext().GetFullName()) + 
                     "::" + enumeration.GetName());
         }
@@ -64,6 +64,12 @@ string GeneratorTypeEnumeration::GetTypedefTypeName()
 {
     const Enumeration &enumeration = typeEnumerationM.GetEnumeration();
 
+    // Like Contexts, an enum of the global namespace is not prefixed with
+    // its name, which is "::"
+    if (!enumeration.GetContext().GetContext()) {
+        return enumeration.GetName();
+    }
+
     return StringUtils::ToString
         (StringUtils::Format(L"%s::%s", enumeration.GetContext().GetFullName(),
                         enumeration.GetName()));